@@ -0,0 +1,34 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *
+ * Project:     My Generic C++ Library
+ * Purpose:     Common definitions of the benchmarks
+ * Author:      György Kövesdi (kgy@etiner.hu)
+ * Licence:     GPL (see file 'COPYING' in the project root for more details)
+ * Comments:    Each benchmark is a function listed in main.cpp
+ *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef __BENCHMARKS_BENCHMARK_H_INCLUDED__
+#define __BENCHMARKS_BENCHMARK_H_INCLUDED__
+
+#include <chrono>
+
+namespace Bench
+{
+    typedef std::chrono::steady_clock Clock;
+
+    /// Returns the seconds elapsed since 'start'
+    inline double Elapsed(const Clock::time_point & start)
+    {
+        return std::chrono::duration<double>(Clock::now() - start).count();
+    }
+
+    void ThreadArrayDispatch(void);
+    void ThreadStart(void);
+    void ObjectPool(void);
+
+} // namespace Bench
+
+#endif /* __BENCHMARKS_BENCHMARK_H_INCLUDED__ */
+
+/* * * * * * * * * * * * * End - of - File * * * * * * * * * * * * * * */
@@ -0,0 +1,55 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *
+ * Project:     My Generic C++ Library
+ * Purpose:     Benchmark runner
+ * Author:      György Kövesdi (kgy@etiner.hu)
+ * Licence:     GPL (see file 'COPYING' in the project root for more details)
+ * Comments:    Usage: basic-benchmarks [name...]
+ *              Without parameters all the benchmarks are executed.
+ *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include "benchmark.h"
+
+#include <iostream>
+#include <string.h>
+
+namespace
+{
+    struct Entry
+    {
+        const char * name;
+        void (*func)(void);
+    };
+
+    const Entry benchmarks[] = {
+        { "thread-array",   &Bench::ThreadArrayDispatch },
+        { "thread-start",   &Bench::ThreadStart },
+        { "object-pool",    &Bench::ObjectPool },
+    };
+}
+
+int main(int argc, char ** argv)
+{
+ int result = 0;
+
+ for (int i = (argc > 1) ? 1 : 0; i < argc; ++i) {
+    bool found = false;
+    for (const Entry & b: benchmarks) {
+        if (argc > 1 && strcmp(argv[i], b.name)) {
+            continue;
+        }
+        std::cout << "* " << b.name << " ------------------ " << std::endl;
+        b.func();
+        found = true;
+    }
+    if (!found) {
+        std::cerr << "Unknown benchmark: " << argv[i] << std::endl;
+        result = 1;
+    }
+ }
+
+ return result;
+}
+
+/* * * * * * * * * * * * * End - of - File * * * * * * * * * * * * * * */
@@ -0,0 +1,107 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *
+ * Project:     My Generic C++ Library
+ * Purpose:     Heap vs. MEM::ObjectPool for messages passed between threads
+ * Author:      György Kövesdi (kgy@etiner.hu)
+ * Licence:     GPL (see file 'COPYING' in the project root for more details)
+ * Comments:
+ *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include "benchmark.h"
+
+#include <Memory/ObjectPool.h>
+#include <Threads/DataPipe.h>
+
+#include <thread>
+#include <vector>
+#include <iostream>
+#include <iomanip>
+#include <iterator>
+
+namespace
+{
+    struct Message
+    {
+        inline Message(int p_id):
+            id(p_id)
+        {
+        }
+
+        int id;
+
+        char payload[120];
+
+    }; // struct Message
+
+    struct HeapDeleter
+    {
+        inline void operator()(Message * msg) const
+        {
+            delete msg;
+        }
+    };
+
+    typedef std::unique_ptr<Message, HeapDeleter> HeapPtr;
+    typedef MEM::pooled_ptr<Message> PooledPtr;
+
+    inline HeapPtr Create(HeapPtr *, int id)
+    {
+        return HeapPtr(new Message(id));
+    }
+
+    inline PooledPtr Create(PooledPtr *, int id)
+    {
+        return MEM::make_pooled<Message>(id);
+    }
+
+    /// The producers create messages, the consumer destroys them on its own thread
+    template <typename Ptr>
+    double Run(int producers, int count)
+    {
+        Threads::DataPipe<Ptr, 1024> pipe;
+        Bench::Clock::time_point start = Bench::Clock::now();
+
+        std::thread consumer([&]() {
+            std::vector<Ptr> batch;
+            for (long left = (long)producers * count; left > 0; ) {
+                batch.clear();
+                left -= pipe.pop_many(std::back_inserter(batch), 256);
+            }
+        });
+
+        std::vector<std::thread> threads;
+        for (int p = 0; p < producers; ++p) {
+            threads.push_back(std::thread([&]() {
+                for (int i = 0; i < count; ++i) {
+                    pipe.push(Create((Ptr *)nullptr, i));
+                }
+            }));
+        }
+        for (auto & t: threads) {
+            t.join();
+        }
+        consumer.join();
+
+        return producers * (double)count / Bench::Elapsed(start);
+    }
+}
+
+void Bench::ObjectPool(void)
+{
+ const int count = 200000;
+
+ std::cout << std::setw(10) << "producers" << std::setw(14) << "heap msg/s" << std::setw(14) << "pool msg/s" << std::endl;
+
+ for (int producers: { 1, 2, 4 }) {
+    double heap = Run<HeapPtr>(producers, count);
+    double pool = Run<PooledPtr>(producers, count);
+    std::cout << std::setw(10) << producers << std::setw(14) << (long)heap << std::setw(14) << (long)pool << std::endl;
+ }
+
+ MEM::ObjectPool<Message>::Stats stats = MEM::ObjectPool<Message>::Instance().GetStats();
+ std::cout << "pool: capacity=" << stats.capacity << " in use=" << stats.inUse << " cached=" << stats.cached
+           << " available=" << stats.available << " hits=" << stats.hits << " misses=" << stats.misses << std::endl;
+}
+
+/* * * * * * * * * * * * * End - of - File * * * * * * * * * * * * * * */
@@ -0,0 +1,109 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *
+ * Project:     My Generic C++ Library
+ * Purpose:     Dispatch rate of Threads::ThreadArray
+ * Author:      György Kövesdi (kgy@etiner.hu)
+ * Licence:     GPL (see file 'COPYING' in the project root for more details)
+ * Comments:    It measures ThreadArray::operator[] only, the jobs do nothing
+ *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include "benchmark.h"
+
+#include <Threads/ThreadArray.h>
+
+#include <atomic>
+#include <thread>
+#include <vector>
+#include <iostream>
+#include <iomanip>
+
+namespace
+{
+    class Array: public Threads::ThreadArray<unsigned, int>
+    {
+     public:
+        inline Array(uint32_t max_threads):
+            Threads::ThreadArray<unsigned, int>(max_threads, 64*1024)
+        {
+        }
+
+        class IdleJob: public Job
+        {
+         public:
+            inline IdleJob(Array & parent):
+                Job(parent, "bench-job")
+            {
+            }
+
+            virtual void Work(int) override
+            {
+            }
+
+        }; // class IdleJob
+
+     private:
+        virtual JobPtr CreateJob(void) override
+        {
+            return JobPtr(new IdleJob(*this));
+        }
+
+    }; // class Array
+
+    /// Calls ThreadArray::operator[] with random keys from some threads
+    /*! \returns    The number of dispatches per second. */
+    double Measure(unsigned keys, uint32_t max_threads, unsigned callers)
+    {
+        Array array(max_threads);
+
+        // Create the threads in advance, thread creation is not measured here:
+        for (unsigned k = 0; k < keys; ++k) {
+            array[k];
+        }
+
+        std::atomic<bool> start(false);
+        std::atomic<uint64_t> total(0);
+        std::vector<std::thread> threads;
+        const uint64_t calls = 200000;
+
+        for (unsigned c = 0; c < callers; ++c) {
+            threads.push_back(std::thread([&, c]() {
+                uint32_t seed = 12345 + c;
+                while (!start.load()) {
+                }
+                for (uint64_t i = 0; i < calls; ++i) {
+                    seed = seed * 1664525 + 1013904223;
+                    array[(seed >> 8) % keys];
+                }
+                total += calls;
+            }));
+        }
+
+        Bench::Clock::time_point t0 = Bench::Clock::now();
+        start.store(true);
+        for (auto & t: threads) {
+            t.join();
+        }
+        return total.load() / Bench::Elapsed(t0);
+    }
+}
+
+void Bench::ThreadArrayDispatch(void)
+{
+ const unsigned keys[] = { 16, 256, 4096 };
+ const unsigned callers[] = { 1, 2, 4, 8 };
+
+ std::cout << std::setw(8) << "keys" << std::setw(10) << "threads" << std::setw(10) << "callers" << std::setw(16) << "dispatch/s" << std::endl;
+
+ for (unsigned k: keys) {
+    // All the keys have their own thread, then a quarter of them (re-use on each miss):
+    for (uint32_t max_threads: { k, k / 4 }) {
+        for (unsigned c: callers) {
+            double rate = Measure(k, max_threads, c);
+            std::cout << std::setw(8) << k << std::setw(10) << max_threads << std::setw(10) << c << std::setw(16) << (uint64_t)rate << std::endl;
+        }
+    }
+ }
+}
+
+/* * * * * * * * * * * * * End - of - File * * * * * * * * * * * * * * */
@@ -0,0 +1,65 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *
+ * Project:     My Generic C++ Library
+ * Purpose:     Cost of creating, starting and joining a Threads::Thread
+ * Author:      György Kövesdi (kgy@etiner.hu)
+ * Licence:     GPL (see file 'COPYING' in the project root for more details)
+ * Comments:    
+ *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include "benchmark.h"
+
+#include <Threads/Threads.h>
+
+#include <iostream>
+#include <iomanip>
+
+namespace
+{
+    class EmptyThread: public Threads::Thread
+    {
+     public:
+        inline EmptyThread(void):
+            Threads::Thread("bench-empty")
+        {
+        }
+
+     protected:
+        virtual int main(void) override
+        {
+            return 0;
+        }
+
+    }; // class EmptyThread
+
+    typedef MEM::shared_ptr<EmptyThread> EmptyPtr;
+}
+
+void Bench::ThreadStart(void)
+{
+ const int count = 2000;
+
+ double create = 0.0, start = 0.0, join = 0.0;
+
+ for (int i = 0; i < count; ++i) {
+    Bench::Clock::time_point t0 = Bench::Clock::now();
+    EmptyPtr thread(new EmptyThread);
+    Bench::Clock::time_point t1 = Bench::Clock::now();
+    Threads::Thread::Start(thread, 64*1024);
+    Bench::Clock::time_point t2 = Bench::Clock::now();
+    thread->Join();
+    Bench::Clock::time_point t3 = Bench::Clock::now();
+    create += std::chrono::duration<double>(t1 - t0).count();
+    start += std::chrono::duration<double>(t2 - t1).count();
+    join += std::chrono::duration<double>(t3 - t2).count();
+ }
+
+ std::cout << std::fixed << std::setprecision(2);
+ std::cout << "create: " << std::setw(8) << create * 1e6 / count << " us" << std::endl;
+ std::cout << "start:  " << std::setw(8) << start * 1e6 / count << " us" << std::endl;
+ std::cout << "join:   " << std::setw(8) << join * 1e6 / count << " us" << std::endl;
+ std::cout << "total:  " << std::setw(8) << (create + start + join) * 1e6 / count << " us" << std::endl;
+}
+
+/* * * * * * * * * * * * * End - of - File * * * * * * * * * * * * * * */
@@ -0,0 +1,148 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *
+ * Project:     My Generic C++ Library
+ * Purpose:     CPU set and scheduling policy definitions
+ * Author:      György Kövesdi (kgy@etiner.hu)
+ * Licence:     GPL (see file 'COPYING' in the project root for more details)
+ * Comments:    Linux-specific (also used by the Android port)
+ *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef __GENERIC_LINUX_THREADS_CPUSET_H_INCLUDED__
+#define __GENERIC_LINUX_THREADS_CPUSET_H_INCLUDED__
+
+#include <Threads/Error.h>
+
+#include <stdlib.h>
+#include <sched.h>
+#include <pthread.h>
+
+namespace Threads
+{
+    /// Scheduling policies of the threads
+    enum SchedPolicy {
+        /// The default time-sharing policy
+        Sched_Other = SCHED_OTHER,
+
+        /// Real-time, first in first out (needs privileges)
+        Sched_FIFO  = SCHED_FIFO,
+
+        /// Real-time, round robin (needs privileges)
+        Sched_RR    = SCHED_RR,
+
+        /// CPU-intensive batch jobs, they are never preferred on wakeup
+        Sched_Batch = SCHED_BATCH,
+
+        /// Very low priority background jobs
+        Sched_Idle  = SCHED_IDLE
+    };
+
+    /// Set of CPUs, e.g. for thread affinity
+    class CpuSet
+    {
+     public:
+        inline CpuSet(void)
+        {
+            Clear();
+        }
+
+        inline void Clear(void)
+        {
+            CPU_ZERO(&mySet);
+        }
+
+        inline CpuSet & Add(int cpu)
+        {
+            ASSERT(cpu >= 0 && cpu < CPU_SETSIZE, "invalid CPU index " << cpu);
+            CPU_SET(cpu, &mySet);
+            return *this;
+        }
+
+        inline CpuSet & Remove(int cpu)
+        {
+            ASSERT(cpu >= 0 && cpu < CPU_SETSIZE, "invalid CPU index " << cpu);
+            CPU_CLR(cpu, &mySet);
+            return *this;
+        }
+
+        inline bool Has(int cpu) const
+        {
+            return cpu >= 0 && cpu < CPU_SETSIZE && CPU_ISSET(cpu, &mySet);
+        }
+
+        /// Returns the number of CPUs in the set
+        inline int Count(void) const
+        {
+            return CPU_COUNT(&mySet);
+        }
+
+        inline bool Empty(void) const
+        {
+            return Count() == 0;
+        }
+
+        /// Adds the CPUs in Linux "cpulist" format, e.g. "0-3,8,10-11"
+        /*! This format is used by the sysfs, see e.g. /sys/devices/system/node/node0/cpulist
+         *  \retval false   The list is malformed; the CPUs before the error have been added. */
+        inline bool AddList(const char * list)
+        {
+            const char * p = list;
+            while (*p && *p != '\n') {
+                char * end;
+                long first = strtol(p, &end, 10);
+                if (end == p || first < 0) {
+                    return false;
+                }
+                long last = first;
+                p = end;
+                if (*p == '-') {
+                    ++p;
+                    last = strtol(p, &end, 10);
+                    if (end == p || last < first) {
+                        return false;
+                    }
+                    p = end;
+                }
+                for (long cpu = first; cpu <= last && cpu < CPU_SETSIZE; ++cpu) {
+                    CPU_SET(cpu, &mySet);
+                }
+                if (*p == ',') {
+                    ++p;
+                }
+            }
+            return true;
+        }
+
+        /// Returns the CPUs the calling thread is allowed to run on
+        inline static CpuSet Allowed(void)
+        {
+            CpuSet result;
+            ASSERT_THREAD_STD(pthread_getaffinity_np(pthread_self(), sizeof(cpu_set_t), &result.mySet));
+            return result;
+        }
+
+        inline bool operator==(const CpuSet & other) const
+        {
+            return CPU_EQUAL(&mySet, &other.mySet);
+        }
+
+        inline const cpu_set_t * get(void) const
+        {
+            return &mySet;
+        }
+
+        inline cpu_set_t * get(void)
+        {
+            return &mySet;
+        }
+
+     private:
+        cpu_set_t mySet;
+
+    }; // class Threads::CpuSet
+
+} // namespace Threads
+
+#endif /* __GENERIC_LINUX_THREADS_CPUSET_H_INCLUDED__ */
+
+/* * * * * * * * * * * * * End - of - File * * * * * * * * * * * * * * */
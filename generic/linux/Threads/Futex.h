@@ -0,0 +1,172 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *
+ * Project:     My Generic C++ Library
+ * Purpose:     Futex-based blocking primitives for lock-free containers
+ * Author:      György Kövesdi (kgy@etiner.hu)
+ * Licence:     GPL (see file 'COPYING' in the project root for more details)
+ * Comments:    Linux-specific (also used by the Android port)
+ *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef __GENERIC_LINUX_THREADS_FUTEX_H_INCLUDED__
+#define __GENERIC_LINUX_THREADS_FUTEX_H_INCLUDED__
+
+#include <Threads/Error.h>
+#include <Threads/Deadline.h>
+
+#include <atomic>
+#include <errno.h>
+#include <limits.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
+
+namespace Threads
+{
+    /// A 32-bit atomic word the threads can sleep on, by the futex system call
+    class Futex
+    {
+     public:
+        inline Futex(int value = 0):
+            myValue(value)
+        {
+        }
+
+        inline int Load(std::memory_order order = std::memory_order_seq_cst) const
+        {
+            return myValue.load(order);
+        }
+
+        inline void Store(int value, std::memory_order order = std::memory_order_seq_cst)
+        {
+            myValue.store(value, order);
+        }
+
+        inline int Increment(void)
+        {
+            return myValue.fetch_add(1) + 1;
+        }
+
+        inline int Decrement(void)
+        {
+            return myValue.fetch_sub(1) - 1;
+        }
+
+        /// Blocks while the value equals to the given one
+        /*! It can return spuriously, the caller must check its own condition again. */
+        inline void Wait(int expected)
+        {
+            syscall(SYS_futex, Address(), FUTEX_WAIT_PRIVATE, expected, nullptr, nullptr, 0);
+        }
+
+        /// Blocks while the value equals to the given one, at most until the deadline
+        /*! \retval false   The deadline has been reached.
+         *  \note   It can return spuriously, the caller must check its own condition again. */
+        inline bool WaitUntil(int expected, const Threads::Deadline & deadline)
+        {
+            // Note: FUTEX_WAIT_BITSET takes absolute CLOCK_MONOTONIC time, as opposed to FUTEX_WAIT
+            struct timespec ts = Threads::ToMonotonic(deadline);
+            if (syscall(SYS_futex, Address(), FUTEX_WAIT_BITSET_PRIVATE, expected, &ts, nullptr, FUTEX_BITSET_MATCH_ANY) != 0) {
+                return errno != ETIMEDOUT;
+            }
+            return true;
+        }
+
+        /// Wakes up the given number of threads blocked in \ref Futex::Wait()
+        inline void Wake(int count = 1)
+        {
+            syscall(SYS_futex, Address(), FUTEX_WAKE_PRIVATE, count, nullptr, nullptr, 0);
+        }
+
+        inline void WakeAll(void)
+        {
+            Wake(INT_MAX);
+        }
+
+     private:
+        inline int * Address(void)
+        {
+            return reinterpret_cast<int *>(&myValue);
+        }
+
+        std::atomic<int> myValue;
+
+    }; // class Threads::Futex
+
+    /// Lets threads sleep until a lock-free condition becomes true
+    /*! The waiter checks the condition again between \ref EventCount::PrepareWait() and
+     *  \ref EventCount::Wait(), and calls \ref EventCount::CancelWait() if it has become true.
+     *  The notifier changes the condition before \ref EventCount::Notify(). */
+    class EventCount
+    {
+     public:
+        inline EventCount(void):
+            myWaiters(0)
+        {
+        }
+
+        /// Registers the caller as a waiter
+        /*! \retval The key to be passed to \ref EventCount::Wait() */
+        inline int PrepareWait(void)
+        {
+            myWaiters.fetch_add(1);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            return myEvent.Load();
+        }
+
+        /// Unregisters the caller, when the condition has become true meanwhile
+        inline void CancelWait(void)
+        {
+            myWaiters.fetch_sub(1);
+        }
+
+        /// Blocks until a notification arrives after \ref EventCount::PrepareWait()
+        inline void Wait(int key)
+        {
+            myEvent.Wait(key);
+            myWaiters.fetch_sub(1);
+        }
+
+        /// Blocks until a notification arrives, or the deadline is reached
+        /*! \retval false   The deadline has been reached. */
+        inline bool WaitUntil(int key, const Threads::Deadline & deadline)
+        {
+            bool result = myEvent.WaitUntil(key, deadline);
+            myWaiters.fetch_sub(1);
+            return result;
+        }
+
+        /// Wakes up one waiting thread, if any
+        inline void Notify(void)
+        {
+            Notify(1);
+        }
+
+        /// Wakes up all the waiting threads
+        inline void NotifyAll(void)
+        {
+            Notify(INT_MAX);
+        }
+
+     private:
+        inline void Notify(int count)
+        {
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (myWaiters.load(std::memory_order_relaxed) == 0) {
+                return;
+            }
+            myEvent.Increment();
+            myEvent.Wake(count);
+        }
+
+        std::atomic<int> myWaiters;
+
+        Futex myEvent;
+
+    }; // class Threads::EventCount
+
+} // namespace Threads
+
+#endif /* __GENERIC_LINUX_THREADS_FUTEX_H_INCLUDED__ */
+
+/* * * * * * * * * * * * * End - of - File * * * * * * * * * * * * * * */
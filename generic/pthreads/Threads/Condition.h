@@ -12,6 +12,11 @@
 #define __SRC_THREADS_CONDITION_H_INCLUDED__
 
 #include <Threads/Mutex.h>
+#include <Threads/Deadline.h>
+
+#include <time.h>
+#include <errno.h>
+#include <stdint.h>
 
 namespace Threads
 {
@@ -20,7 +25,12 @@ namespace Threads
      public:
         inline Condition(void)
         {
-            ASSERT_THREAD_STD(pthread_cond_init(&myCond, NULL));
+            pthread_condattr_t attr;
+            ASSERT_THREAD_STD(pthread_condattr_init(&attr));
+            // The timed waits must not be affected by setting the system clock:
+            ASSERT_THREAD_STD(pthread_condattr_setclock(&attr, CLOCK_MONOTONIC));
+            ASSERT_THREAD_STD(pthread_cond_init(&myCond, &attr));
+            pthread_condattr_destroy(&attr);
         }
 
         inline ~Condition(void)
@@ -46,10 +56,59 @@ namespace Threads
             Signal();
         }
 
+        /// Wakes up all the waiting threads
+        /*! This function can be called if the corresponding mutex has already been locked. */
+        inline void Broadcast(void)
+        {
+            ASSERT_THREAD_STD(pthread_cond_broadcast(&myCond));
+        }
+
         /// Waits for the Signal
         inline void Wait(Threads::Mutex & mutex)
         {
-            ASSERT_THREAD_STD(pthread_cond_wait(&myCond, &mutex.myMutex));
+            if (mutex.myStats) {
+                mutex.Unlocking();
+            }
+            int result = pthread_cond_wait(&myCond, &mutex.myMutex);
+            if (mutex.myStats) {
+                mutex.Relocked();
+            }
+            ASSERT_THREAD_STD(result);
+        }
+
+        /// Waits for the Signal, at most until the given time
+        /*! \retval false   The deadline has been reached without signal.
+         *  \note   Spurious wakeups are possible, as in the case of \ref Condition::Wait(Threads::Mutex &) */
+        inline bool WaitUntil(Threads::Mutex & mutex, const Threads::Deadline & deadline)
+        {
+            struct timespec ts = Threads::ToMonotonic(deadline);
+            if (mutex.myStats) {
+                mutex.Unlocking();
+            }
+            int result = pthread_cond_timedwait(&myCond, &mutex.myMutex, &ts);
+            if (mutex.myStats) {
+                mutex.Relocked();
+            }
+            if (result == ETIMEDOUT) {
+                return false;
+            }
+            ASSERT_THREAD_STD(result);
+            return true;
+        }
+
+        /// Waits for the Signal, at most for the given time
+        /*! \see Condition::WaitUntil() */
+        template <class Rep, class Period>
+        inline bool WaitFor(Threads::Mutex & mutex, const std::chrono::duration<Rep, Period> & timeout)
+        {
+            return WaitUntil(mutex, Threads::DeadlineAfter(timeout));
+        }
+
+        /// Waits for the Signal, at most for the given time
+        /*! \see Condition::WaitUntil() */
+        inline bool Wait(Threads::Mutex & mutex, uint32_t milliseconds)
+        {
+            return WaitUntil(mutex, Threads::DeadlineAfterMilliseconds(milliseconds));
         }
 
      private:
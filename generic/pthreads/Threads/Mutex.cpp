@@ -0,0 +1,188 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *
+ * Project:     My Generic C++ Library
+ * Purpose:     Mutex contention statistics
+ * Author:      György Kövesdi (kgy@etiner.hu)
+ * Licence:     GPL (see file 'COPYING' in the project root for more details)
+ * Comments:
+ *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include "Mutex.h"
+
+#include <map>
+#include <iomanip>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+using namespace Threads;
+
+namespace
+{
+    /// Protects the registry
+    /*! \note   It is a raw pthread mutex, because it is used during the static initialization. */
+    pthread_mutex_t registryMutex = PTHREAD_MUTEX_INITIALIZER;
+
+    typedef std::map<std::string, MutexStats *> Registry;
+
+    /// All the statistics records, by name
+    /*! \note   It is never deleted, because the mutexes can be used during exit. */
+    Registry * registry = nullptr;
+
+    /// State of the instrumentation: -1 means not initialized yet
+    std::atomic<int> enabled(-1);
+
+    /// True if the environment variable has enabled the statistics
+    bool enabledByEnvironment = false;
+
+    inline uint64_t Now(void)
+    {
+        struct timespec ts;
+        clock_gettime(CLOCK_MONOTONIC, &ts);
+        return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+    }
+
+    void ReportAtExit(void)
+    {
+        MutexStats::Report(std::cerr);
+    }
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *\
+ *                                                                                       *
+ *     class MutexStats:                                                                 *
+ *                                                                                       *
+\* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+bool MutexStats::IsEnabled(void)
+{
+ int state = enabled.load(std::memory_order_relaxed);
+
+ if (state < 0) {
+    const char * env = getenv("BASELIB_MUTEX_STATS");
+    enabledByEnvironment = env && *env && strcmp(env, "0");
+    int expected = -1;
+    enabled.compare_exchange_strong(expected, enabledByEnvironment ? 1 : 0);
+    state = enabled.load(std::memory_order_relaxed);
+ }
+
+ return state > 0;
+}
+
+void MutexStats::Enable(bool enable)
+{
+ enabled.store(enable ? 1 : 0);
+}
+
+MutexStats * MutexStats::Get(const char * name)
+{
+ if (!IsEnabled()) {
+    return nullptr;
+ }
+
+ pthread_mutex_lock(&registryMutex);
+
+ if (!registry) {
+    registry = new Registry;
+    if (enabledByEnvironment) {
+        atexit(&ReportAtExit);
+    }
+ }
+
+ MutexStats * & result = (*registry)[name];
+ if (!result) {
+    result = new MutexStats(name);
+ }
+
+ pthread_mutex_unlock(&registryMutex);
+
+ return result;
+}
+
+void MutexStats::Report(std::ostream & os)
+{
+ pthread_mutex_lock(&registryMutex);
+
+ if (registry) {
+    os << "Mutex statistics:" << std::endl;
+    os << std::setw(24) << "name" << std::setw(14) << "locks" << std::setw(14) << "contended"
+       << std::setw(14) << "wait [ms]" << std::setw(14) << "max hold [us]" << std::endl;
+    for (Registry::const_iterator i = registry->begin(); i != registry->end(); ++i) {
+        const MutexStats & stats = *i->second;
+        os << std::setw(24) << i->first
+           << std::setw(14) << stats.acquisitions.load()
+           << std::setw(14) << stats.contended.load()
+           << std::setw(14) << std::fixed << std::setprecision(3) << stats.waitTime.load() / 1e6
+           << std::setw(14) << std::fixed << std::setprecision(3) << stats.maxHoldTime.load() / 1e3
+           << std::endl;
+    }
+ }
+
+ pthread_mutex_unlock(&registryMutex);
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *\
+ *                                                                                       *
+ *     class Mutex:                                                                      *
+ *                                                                                       *
+\* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+void Mutex::AcquireInstrumented(void)
+{
+ if (pthread_mutex_trylock(&myMutex) == 0) {
+    Locked(false, 0);
+    return;
+ }
+
+ uint64_t start = Now();
+
+ if (!mySpin || !Spin()) {
+    ASSERT_THREAD_STD(pthread_mutex_lock(&myMutex));
+ }
+
+ Locked(true, start);
+}
+
+void Mutex::Locked(bool contended, uint64_t start)
+{
+ if (myDepth++) {
+    // Recursive lock, it has already been counted
+    return;
+ }
+
+ uint64_t now = Now();
+
+ myStats->acquisitions.fetch_add(1, std::memory_order_relaxed);
+
+ if (contended) {
+    myStats->contended.fetch_add(1, std::memory_order_relaxed);
+    myStats->waitTime.fetch_add(now - start, std::memory_order_relaxed);
+ }
+
+ myLockedAt = now;
+}
+
+void Mutex::Relocked(void)
+{
+ if (myDepth++) {
+    return;
+ }
+
+ myLockedAt = Now();
+}
+
+void Mutex::Unlocking(void)
+{
+ if (--myDepth) {
+    return;
+ }
+
+ uint64_t hold = Now() - myLockedAt;
+
+ uint64_t max = myStats->maxHoldTime.load(std::memory_order_relaxed);
+ while (hold > max && !myStats->maxHoldTime.compare_exchange_weak(max, hold, std::memory_order_relaxed)) {
+ }
+}
+
+/* * * * * * * * * * * * * End - of - File * * * * * * * * * * * * * * */
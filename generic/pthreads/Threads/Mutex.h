@@ -12,11 +12,16 @@
 #define __SRC_THREADS_MUTEX_H_INCLUDED__
 
 #include <Threads/Error.h>
+#include <System/Generic.h>
 
 #include <pthread.h>
 #include <Memory/Memory.h>
 
+#include <atomic>
+#include <string>
+#include <ostream>
 #include <iostream>
+#include <stdint.h>
 
 namespace Threads
 {
@@ -24,6 +29,55 @@ namespace Threads
     class TryLock;
     class Condition;
 
+    /// Contention statistics of the mutexes having the same name
+    /*! They are collected if BASELIB_MUTEX_STATS is set, and printed to the standard error at exit. */
+    class MutexStats
+    {
+     public:
+        /// Returns the record of the given name
+        /*! \retval nullptr     The statistics are disabled. */
+        static MutexStats * Get(const char * name);
+
+        /// Returns true if the new mutexes are instrumented
+        static bool IsEnabled(void);
+
+        /// Enables or disables the instrumentation of the mutexes created later
+        static void Enable(bool enable);
+
+        /// Prints all the records
+        static void Report(std::ostream & os);
+
+        inline const std::string & GetName(void) const
+        {
+            return myName;
+        }
+
+        /// Number of locks
+        std::atomic<uint64_t> acquisitions;
+
+        /// Number of locks when the mutex was held by another thread
+        std::atomic<uint64_t> contended;
+
+        /// Total time spent waiting for the mutex, in nanoseconds
+        std::atomic<uint64_t> waitTime;
+
+        /// The longest time the mutex was held, in nanoseconds
+        std::atomic<uint64_t> maxHoldTime;
+
+     private:
+        inline MutexStats(const char * name):
+            acquisitions(0),
+            contended(0),
+            waitTime(0),
+            maxHoldTime(0),
+            myName(name)
+        {
+        }
+
+        std::string myName;
+
+    }; // class MutexStats
+
     class Mutex
     {
         friend class Lock;
@@ -31,17 +85,25 @@ namespace Threads
         friend class Condition;
 
      protected:
-        inline Mutex(bool recursive)
+        /*! \param  spin    The number of lock attempts before blocking, see \ref Threads::MutexAdaptive */
+        inline Mutex(int type, const char * name, unsigned spin = 0):
+            mySpin(spin),
+            myStats(name ? MutexStats::Get(name) : nullptr),
+            myDepth(0),
+            myLockedAt(0)
         {
             pthread_mutexattr_t attr;
             ASSERT_THREAD_STD(pthread_mutexattr_init(&attr));
-            ASSERT_THREAD_STD(pthread_mutexattr_settype(&attr, recursive ? PTHREAD_MUTEX_RECURSIVE : PTHREAD_MUTEX_NORMAL));
+            ASSERT_THREAD_STD(pthread_mutexattr_settype(&attr, type));
             ASSERT_THREAD_STD(pthread_mutex_init(&myMutex, &attr));
+            pthread_mutexattr_destroy(&attr);
         }
 
      public:
-        inline Mutex(void):
-            Mutex(false)
+        /// Constructor
+        /*! \param  name    If it is given, the contention of the mutex can be measured, see \ref Threads::MutexStats */
+        inline Mutex(const char * name = nullptr):
+            Mutex(PTHREAD_MUTEX_NORMAL, name)
         {
         }
 
@@ -68,32 +130,124 @@ namespace Threads
         }
 
      private:
+        inline void Acquire(void)
+        {
+            if (myStats) {
+                AcquireInstrumented();
+                return;
+            }
+            if (mySpin && Spin()) {
+                return;
+            }
+            ASSERT_THREAD_STD(pthread_mutex_lock(&myMutex));
+        }
+
+        /// Tries to lock without blocking
+        /*! \returns    Zero on success, or the error code of pthread_mutex_trylock() */
+        inline int TryAcquire(void)
+        {
+            int status = pthread_mutex_trylock(&myMutex);
+            if (status == 0 && myStats) {
+                Locked(false, 0);
+            }
+            return status;
+        }
+
+        /// Unlocks the mutex
+        /*! \returns    Zero on success, or the error code of pthread_mutex_unlock() */
+        inline int Release(void)
+        {
+            if (myStats) {
+                Unlocking();
+            }
+            return pthread_mutex_unlock(&myMutex);
+        }
+
+        /// Tries to lock the mutex \ref Mutex::mySpin times
+        inline bool Spin(void)
+        {
+            unsigned pause = 1;
+            for (unsigned i = 0; i < mySpin; ++i) {
+                if (pthread_mutex_trylock(&myMutex) == 0) {
+                    return true;
+                }
+                for (unsigned j = 0; j < pause; ++j) {
+                    CPU_RELAX();
+                }
+                if (pause < 16) {
+                    pause *= 2;
+                }
+            }
+            return false;
+        }
+
+        /// Locks the mutex and collects the statistics
+        void AcquireInstrumented(void);
+
+        /// Updates the statistics after locking
+        /*! \param  contended   True if the mutex was held by another thread.
+         *  \param  start       The time the locking was started at (if contended). */
+        void Locked(bool contended, uint64_t start);
+
+        /// Updates the statistics when the mutex is locked again after a wait on a \ref Threads::Condition
+        /*! It is not counted as a new acquisition, only the hold time is restarted. */
+        void Relocked(void);
+
+        /// Updates the statistics before unlocking
+        void Unlocking(void);
+
         pthread_mutex_t myMutex;
 
+        /// Number of lock attempts before blocking
+        unsigned mySpin;
+
+        /// The statistics, or nullptr if this mutex is not instrumented
+        MutexStats * myStats;
+
+        /// Lock depth of recursive mutexes (instrumented mode only)
+        int myDepth;
+
+        /// The time of the last lock, in nanoseconds (instrumented mode only)
+        uint64_t myLockedAt;
+
     }; // class Mutex
 
     class MutexRecursive: public Mutex
     {
      public:
-        MutexRecursive(void):
-            Mutex(true)
+        MutexRecursive(const char * name = nullptr):
+            Mutex(PTHREAD_MUTEX_RECURSIVE, name)
         {
         }
 
     }; // MutexRecursive
 
+    /// Mutex spinning for a while before blocking, for short critical sections
+    class MutexAdaptive: public Mutex
+    {
+     public:
+        /// Constructor
+        /*! \param  name    See \ref Threads::Mutex::Mutex()
+         *  \param  spin    The number of lock attempts before blocking. */
+        MutexAdaptive(const char * name = nullptr, unsigned spin = 100):
+            Mutex(PTHREAD_MUTEX_NORMAL, name, spin)
+        {
+        }
+
+    }; // MutexAdaptive
+
     class Lock
     {
      public:
         inline Lock(Mutex & mutex):
             myMutex(mutex)
         {
-            ASSERT_THREAD_STD(pthread_mutex_lock(&myMutex.myMutex));
+            myMutex.Acquire();
         }
 
         inline ~Lock()
         {
-            if (pthread_mutex_unlock(&myMutex.myMutex)) {
+            if (myMutex.Release()) {
                 // Cannot throw here. Also cannot emit any debug message due to
                 // eldless loop possibility.
                 std::cerr << "ERROR: could not unlock mutex" << std::endl;
@@ -111,13 +265,13 @@ namespace Threads
         inline TryLock(Mutex & mutex):
             myMutex(mutex)
         {
-            myStatus = pthread_mutex_trylock(&myMutex.myMutex);
+            myStatus = myMutex.TryAcquire();
         }
 
         inline ~TryLock()
         {
             if (IsLocked()) {
-                if (pthread_mutex_unlock(&myMutex.myMutex)) {
+                if (myMutex.Release()) {
                     // Cannot throw here. Also cannot emit any debug message due to
                     // eldless loop possibility.
                     std::cerr << "ERROR: could not unlock mutex" << std::endl;
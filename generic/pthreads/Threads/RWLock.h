@@ -0,0 +1,180 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *
+ * Project:     My Generic C++ Library
+ * Purpose:     Reader-writer lock classes for my thread control
+ * Author:      György Kövesdi (kgy@etiner.hu)
+ * Licence:     GPL (see file 'COPYING' in the project root for more details)
+ * Comments:    
+ *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef __SRC_THREADS_RWLOCK_H_INCLUDED__
+#define __SRC_THREADS_RWLOCK_H_INCLUDED__
+
+#include <Threads/Error.h>
+#include <Memory/Memory.h>
+
+#include <pthread.h>
+#include <string.h>
+#include <iostream>
+
+namespace Threads
+{
+    class ReadLock;
+    class WriteLock;
+    class TryReadLock;
+    class TryWriteLock;
+
+    /// Reader-writer lock, the writers are preferred
+    /*! \warning    The read lock must not be acquired recursively, a waiting writer would deadlock it. */
+    class RWLock: public MEM::noncopyable
+    {
+        friend class ReadLock;
+        friend class WriteLock;
+        friend class TryReadLock;
+        friend class TryWriteLock;
+
+     public:
+        inline RWLock(void)
+        {
+            pthread_rwlockattr_t attr;
+            ASSERT_THREAD_STD(pthread_rwlockattr_init(&attr));
+            ASSERT_THREAD_STD(pthread_rwlockattr_setkind_np(&attr, PTHREAD_RWLOCK_PREFER_WRITER_NONRECURSIVE_NP));
+            ASSERT_THREAD_STD(pthread_rwlock_init(&myLock, &attr));
+            pthread_rwlockattr_destroy(&attr);
+        }
+
+        inline ~RWLock() throw()
+        {
+            int errorcode = pthread_rwlock_destroy(&myLock);
+            if (errorcode) {
+                std::cerr << "ERROR: Could not destroy rwlock: " << strerror(errorcode) << std::endl;
+            }
+        }
+
+     private:
+        /// Releases both the read and write locks
+        inline void Unlock(void)
+        {
+            if (pthread_rwlock_unlock(&myLock)) {
+                // Cannot throw here. Also cannot emit any debug message due to
+                // eldless loop possibility.
+                std::cerr << "ERROR: could not unlock rwlock" << std::endl;
+            }
+        }
+
+        pthread_rwlock_t myLock;
+
+    }; // class RWLock
+
+    /// Holds the read lock while it exists
+    class ReadLock
+    {
+     public:
+        inline ReadLock(RWLock & lock):
+            myLock(lock)
+        {
+            ASSERT_THREAD_STD(pthread_rwlock_rdlock(&myLock.myLock));
+        }
+
+        inline ~ReadLock()
+        {
+            myLock.Unlock();
+        }
+
+     private:
+        RWLock & myLock;
+
+    }; // class ReadLock
+
+    /// Holds the write lock while it exists
+    class WriteLock
+    {
+     public:
+        inline WriteLock(RWLock & lock):
+            myLock(lock)
+        {
+            ASSERT_THREAD_STD(pthread_rwlock_wrlock(&myLock.myLock));
+        }
+
+        inline ~WriteLock()
+        {
+            myLock.Unlock();
+        }
+
+     private:
+        RWLock & myLock;
+
+    }; // class WriteLock
+
+    class TryReadLock
+    {
+     public:
+        inline TryReadLock(RWLock & lock):
+            myLock(lock)
+        {
+            myStatus = pthread_rwlock_tryrdlock(&myLock.myLock);
+        }
+
+        inline ~TryReadLock()
+        {
+            if (IsLocked()) {
+                myLock.Unlock();
+            }
+        }
+
+        inline bool IsLocked(void) const
+        {
+            return myStatus == 0;
+        }
+
+        inline int GetStatus(void) const
+        {
+            return myStatus;
+        }
+
+     private:
+        RWLock & myLock;
+
+        int myStatus;
+
+    }; // class TryReadLock
+
+    class TryWriteLock
+    {
+     public:
+        inline TryWriteLock(RWLock & lock):
+            myLock(lock)
+        {
+            myStatus = pthread_rwlock_trywrlock(&myLock.myLock);
+        }
+
+        inline ~TryWriteLock()
+        {
+            if (IsLocked()) {
+                myLock.Unlock();
+            }
+        }
+
+        inline bool IsLocked(void) const
+        {
+            return myStatus == 0;
+        }
+
+        inline int GetStatus(void) const
+        {
+            return myStatus;
+        }
+
+     private:
+        RWLock & myLock;
+
+        int myStatus;
+
+    }; // class TryWriteLock
+
+} // namespace Threads
+
+#endif /* __SRC_THREADS_RWLOCK_H_INCLUDED__ */
+
+/* * * * * * * * * * * * * End - of - File * * * * * * * * * * * * * * */
@@ -12,7 +12,10 @@
 #define __OPSYS_UNIX_THREADS_SEMAPHORE_H_INCLUDED__
 
 #include <Threads/Error.h>
+#include <Threads/Deadline.h>
+#include <Threads/SemaphoreWait.h>
 
+#include <errno.h>
 #include <stdint.h>
 #include <semaphore.h>
 
@@ -33,15 +36,34 @@ namespace Threads
 
         inline void Wait(void)
         {
-            sem_wait(&mySemaphore);
+            while (sem_wait(&mySemaphore) && errno == EINTR) {
+            }
         }
 
-        inline void Wait(uint32_t milliseconds)
+        /// Waits for the semaphore, at most until the given time
+        /*! \retval false   The deadline has been reached.
+         *  \see    Threads::SemaphoreWaitUntil() for the platform-specific details */
+        inline bool WaitUntil(const Threads::Deadline & deadline)
         {
-            struct timespec ts;
-            ts.tv_sec = milliseconds / 1000U;
-            ts.tv_nsec = (milliseconds % 1000U) * 1000000U;
-            sem_timedwait(&mySemaphore, &ts);
+            while (Threads::SemaphoreWaitUntil(&mySemaphore, deadline)) {
+                if (errno != EINTR) {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        template <class Rep, class Period>
+        inline bool WaitFor(const std::chrono::duration<Rep, Period> & timeout)
+        {
+            return WaitUntil(Threads::DeadlineAfter(timeout));
+        }
+
+        /// Waits for the semaphore, at most for the given time
+        /*! \see Semaphore::WaitUntil() */
+        inline bool Wait(uint32_t milliseconds)
+        {
+            return WaitUntil(Threads::DeadlineAfterMilliseconds(milliseconds));
         }
 
         inline bool TryWait(void)
@@ -11,11 +11,11 @@
 
 #include "Threads.h"
 
-#include <Threads/Condition.h>
-#include <Threads/Mutex.h>
+#include <System/Numa.h>
 #include <Debug/Debug.h>
 
 #include <string>
+#include <string.h>
 #include <unistd.h>
 #include <sys/types.h>
 #include <sys/time.h>
@@ -26,33 +26,6 @@ SYS_DEFINE_MODULE(DM_THREAD);
 
 using PTHREAD::Thread;
 
-/// Helper struct to start threads
-struct ThreadInfo
-{
-    inline ThreadInfo(ThreadPtr & thread):
-        thread(thread)
-    {
-    }
-
-    inline void Wait(void)
-    {
-        startCondition.Wait(startMutex);
-    }
-
-    inline void Signal(void)
-    {
-        Threads::Lock _l(startMutex);
-        startCondition.Signal();
-    }
-
-    ThreadPtr & thread;
-
-    Threads::Mutex startMutex;
-
-    Threads::Condition startCondition;
-
-}; // struct ThreadInfo
-
 /* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *\
  *                                                                                       *
  *     class Thread:                                                                     *
@@ -63,7 +36,11 @@ Thread::Thread(const char * name):
     myThread(0),
     myThreadName(name),
     toBeFinished(true),
-    isFinished(true)
+    isFinished(true),
+    myTid(0),
+    myNice(INT_MIN),
+    mySchedParam(PackSchedParam(-1, 0)),
+    myNumaNode(-1)
 {
  SYS_DEBUG_MEMBER(DM_THREAD);
 
@@ -122,20 +99,21 @@ void Thread::StartInternal(ThreadPtr & thread, size_t stack)
 {
  SYS_DEBUG_STATIC(DM_THREAD);
 
- ThreadInfo info(thread);               // For inter-thread communication
-
- Threads::Lock _l(info.startMutex);
-
  // If it has already been started, do nothing:
  if (!thread->IsFinished()) {
     return;
  }
 
- thread->StartInternal(info, stack);    // Start the thread
+ thread->mySelf = thread;
+
+ // The new thread takes over this copy, it keeps itself alive while main() is running:
+ thread->StartInternal(new ThreadPtr(thread), stack);
 }
 
 /// Start the thread (internal version)
-void Thread::StartInternal(ThreadInfo & info, size_t stack)
+/*! It does not wait for the new thread: the smart pointer is passed on the heap, and the new thread
+ *  deletes it. */
+void Thread::StartInternal(ThreadPtr * self, size_t stack)
 {
  SYS_DEBUG_MEMBER(DM_THREAD);
 
@@ -146,13 +124,19 @@ void Thread::StartInternal(ThreadInfo & info, size_t stack)
  // Set the attributes
  myAttr.SetStackSize(stack);
  myAttr.SetJoinable(true);
+ if (!myAffinity.Empty()) {
+    myAttr.SetAffinity(myAffinity);
+ }
 
  SYS_DEBUG(DL_INFO1, "Creating Thread '" << getThreadName() << "' ...");
  // Create the thread:
- ASSERT_THREAD(pthread_create(&myThread, myAttr.get(), &Thread::_main, &info)==0, "pthread_create() failed");
-
- // Wait until the thread copies its smart pointer
- info.Wait();
+ int result = pthread_create(&myThread, myAttr.get(), &Thread::_main, self);
+ if (result != 0) {
+    toBeFinished = true;
+    isFinished = true;
+    delete self;
+ }
+ ASSERT_THREAD(result==0, "pthread_create() failed: " << strerror(result));
 
  SYS_DEBUG(DL_INFO1, "Thread '" << getThreadName() << "' started");
 }
@@ -160,29 +144,29 @@ void Thread::StartInternal(ThreadInfo & info, size_t stack)
 /// The physical start of the thread
 /*! This is just a helper function, calling the real main() function.
  */
-void * Thread::_main(void * p_info)
+void * Thread::_main(void * p_self)
 {
  SYS_DEBUG_STATIC(DM_THREAD);
 
  ThreadPtr self;
 
  {
-    ThreadInfo & info = *reinterpret_cast<ThreadInfo *>(p_info);
+    ThreadPtr * p = reinterpret_cast<ThreadPtr *>(p_self);
     // Keep itself alive while main() is running:
-    self = info.thread;
-    // Also store the self pointer:
-    self->mySelf = self;
-    // Smart pointers have been updated, caller may continue:
-    info.Signal();
-    // Note: the content of 'info' is not available from this point.
+    self.swap(*p);
+    delete p;
  }
 
  int status = 0;
 
+ self->myTid = Threads::getTid();
+ self->ApplyStartSettings();
+
  self->before_main();   // Can change the thread name if necessary - for the log to be consistent
 
  // Set the thread name:
- if (!self->setThreadName()) {
+ // Note: the parent may not have stored 'myThread' yet, so pthread_self() is used here
+ if (pthread_setname_np(pthread_self(), self->myThreadName.c_str()) != 0) {
     DEBUG_OUT("Could not set name of thread " << self->getThreadName());
  }
 
@@ -214,14 +198,49 @@ void * Thread::_main(void * p_info)
 
  SYS_DEBUG(DL_INFO1, "Thread '" << self->getThreadName() << "' has exited normally, status=" << status);
 
+ self->myTid = 0;
  self->isFinished = true;
 
  return (void*)0;
 }
 
+void Thread::ApplyStartSettings(void)
+{
+ SYS_DEBUG_MEMBER(DM_THREAD);
+
+ int nice = myNice;
+ if (nice != INT_MIN && setpriority(PRIO_PROCESS, myTid, nice) != 0) {
+    DEBUG_OUT("Thread '" << getThreadName() << "': could not set priority " << nice);
+ }
+
+ uint64_t sched = mySchedParam;
+ int policy = (int32_t)(sched >> 32);
+ if (policy >= 0) {
+    struct sched_param param;
+    param.sched_priority = (int32_t)(uint32_t)sched;
+    if (pthread_setschedparam(pthread_self(), policy, &param) != 0) {
+        DEBUG_OUT("Thread '" << getThreadName() << "': could not set scheduling policy " << policy);
+    }
+ }
+
+ int node = myNumaNode;
+ if (node >= 0 && !SYS::Numa::setMemoryPolicy(SYS::Numa::Mem_Preferred, node)) {
+    DEBUG_OUT("Thread '" << getThreadName() << "': could not set memory policy for node " << node);
+ }
+}
+
+/*! \note   The kernel thread ID is used here, because PRIO_PROCESS with zero would change the
+ *          priority of the calling thread only, not this one. */
 int Thread::GetPriority(void) const
 {
- return getpriority(PRIO_PROCESS, 0);
+ pid_t tid = myTid;
+
+ if (!tid) {
+    int nice = myNice;
+    return nice == INT_MIN ? 0 : nice;
+ }
+
+ return getpriority(PRIO_PROCESS, tid);
 }
 
 bool Thread::SetPriority(int prio)
@@ -229,7 +248,75 @@ bool Thread::SetPriority(int prio)
  SYS_DEBUG_MEMBER(DM_THREAD);
  SYS_DEBUG(DL_INFO1, "Priotiry is set to " << prio);
 
- return setpriority(PRIO_PROCESS, 0, prio) == 0;
+ // Note: if the thread is just starting, it is applied by the thread too, see ApplyStartSettings()
+ myNice = prio;
+
+ pid_t tid = myTid;
+ if (!tid) {
+    return true;
+ }
+
+ return setpriority(PRIO_PROCESS, tid, prio) == 0;
+}
+
+bool Thread::SetAffinity(const Threads::CpuSet & cpus)
+{
+ SYS_DEBUG_MEMBER(DM_THREAD);
+
+ myAffinity = cpus;
+
+ if (IsFinished()) {
+    return true;
+ }
+
+ return pthread_setaffinity_np(myThread, sizeof(cpu_set_t), cpus.get()) == 0;
+}
+
+Threads::CpuSet Thread::GetAffinity(void) const
+{
+ if (IsFinished()) {
+    return myAffinity;
+ }
+
+ Threads::CpuSet result;
+ ASSERT_THREAD_STD(pthread_getaffinity_np(myThread, sizeof(cpu_set_t), result.get()));
+
+ return result;
+}
+
+bool Thread::SetSchedPolicy(Threads::SchedPolicy policy, int priority)
+{
+ SYS_DEBUG_MEMBER(DM_THREAD);
+ SYS_DEBUG(DL_INFO1, "Scheduling policy is set to " << (int)policy << "/" << priority);
+
+ mySchedParam = PackSchedParam(policy, priority);
+
+ if (IsFinished()) {
+    return true;
+ }
+
+ struct sched_param param;
+ param.sched_priority = priority;
+
+ return pthread_setschedparam(myThread, policy, &param) == 0;
+}
+
+bool Thread::SetNumaNode(int node)
+{
+ SYS_DEBUG_MEMBER(DM_THREAD);
+
+ Threads::CpuSet cpus;
+ if (!SYS::Numa::getNodeCpus(node, cpus) || cpus.Empty()) {
+    return false;
+ }
+
+ myNumaNode = node;
+
+ if (!IsFinished() && pthread_equal(myThread, pthread_self())) {
+    SYS::Numa::setMemoryPolicy(SYS::Numa::Mem_Preferred, node);
+ }
+
+ return SetAffinity(cpus);
 }
 
 pid_t Threads::getTid(void)
@@ -12,19 +12,21 @@
 #define __SRC_THREADS_THREADS_H_INCLUDED__
 
 #include <Threads/Error.h>
+#include <Threads/CpuSet.h>
 #include <Memory/Memory.h>
 #include <Debug/Debug.h>
 
 #include <iostream>
+#include <atomic>
+#include <climits>
 #include <exception>
+#include <stdint.h>
 #include <pthread.h>
 #include <sched.h>
 #include <errno.h>
 
 SYS_DECLARE_MODULE(DM_THREAD);
 
-struct ThreadInfo;
-
 namespace Threads
 {
     pid_t getTid(void);
@@ -57,9 +59,28 @@ namespace PTHREAD
 
         void Kill(bool is_join = true);
         void Join(void);
+
+        /// Sets the nice value of this thread
+        /*! If the thread is not running, the value is applied when it is started. */
         bool SetPriority(int prio);
         int GetPriority(void) const;
 
+        /// Sets the CPUs this thread can run on, now or at the start
+        /*! \retval false   The affinity could not be changed (see errno). */
+        bool SetAffinity(const Threads::CpuSet & cpus);
+
+        /// Returns the CPUs this thread can run on, or the value to be set at start
+        Threads::CpuSet GetAffinity(void) const;
+
+        /// Sets the scheduling policy of this thread, now or at the start
+        /*! \param  priority    It must be zero, except for \ref Threads::Sched_FIFO and \ref Threads::Sched_RR (1...99).
+         *  \note   Errors at start time cannot be reported. */
+        bool SetSchedPolicy(Threads::SchedPolicy policy, int priority = 0);
+
+        /// Binds this thread (CPU affinity and memory policy) to a NUMA node
+        /*! \note   The memory policy is applied at the next start, unless it is called by the thread itself. */
+        bool SetNumaNode(int node);
+
         /*! This function can be called by the main function to get the exit request.
          *  \note   The virtual function \ref Thread::KillSignal() is also called when this flag
          *          is set to signal the thread if necessary. That may be a better solution. */
@@ -147,6 +168,11 @@ namespace PTHREAD
                 ASSERT_THREAD(pthread_attr_setstacksize(&myAttrib, stack)==0, "pthread_attr_setstacksize(" << stack << ") failed");
             }
 
+            inline void SetAffinity(const Threads::CpuSet & cpus)
+            {
+                ASSERT_THREAD(pthread_attr_setaffinity_np(&myAttrib, sizeof(cpu_set_t), cpus.get())==0, "pthread_attr_setaffinity_np() failed");
+            }
+
             inline pthread_attr_t * get()
             {
                 return &myAttrib;
@@ -194,18 +220,42 @@ namespace PTHREAD
         {
         }
 
-        void StartInternal(ThreadInfo & info, size_t stack);
+        void StartInternal(ThreadPtr * self, size_t stack);
         static void StartInternal(ThreadPtr & thread, size_t stack = 1024*1024);
 
-        static void * _main(void * info);
+        static void * _main(void * self);
 
      private:
+        /// Applies the settings stored before the start, called by the new thread itself
+        void ApplyStartSettings(void);
+
         bool toBeFinished;
 
         bool isFinished;
 
         Attribute myAttr;
 
+        /// The kernel thread ID, or zero if the thread has not been started yet
+        std::atomic<pid_t> myTid;
+
+        /// The nice value to be set at start, or INT_MIN if it is not set
+        std::atomic<int> myNice;
+
+        /// Packs a scheduling policy and priority into one value, see \ref Thread::mySchedParam
+        static inline uint64_t PackSchedParam(int policy, int priority)
+        {
+            return (uint64_t)(uint32_t)policy << 32 | (uint32_t)priority;
+        }
+
+        /// The scheduling policy (upper 32 bits, -1 if not set) and priority to be set at start
+        std::atomic<uint64_t> mySchedParam;
+
+        /// The NUMA node to be used, or -1 if it is not set
+        std::atomic<int> myNumaNode;
+
+        /// The affinity set at start, it is valid if it is not empty
+        Threads::CpuSet myAffinity;
+
         ThreadWeak mySelf;
 
     }; // class PTHREAD::Thread
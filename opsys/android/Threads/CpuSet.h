@@ -0,0 +1 @@
+../../../generic/linux/Threads/CpuSet.h
\ No newline at end of file
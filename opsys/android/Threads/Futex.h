@@ -0,0 +1 @@
+../../../generic/linux/Threads/Futex.h
\ No newline at end of file
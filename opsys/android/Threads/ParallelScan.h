@@ -0,0 +1 @@
+../../../src/Threads/ParallelScan.h
\ No newline at end of file
@@ -0,0 +1,32 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *
+ * Project:     Android Interface
+ * Purpose:     Timed wait for a semaphore
+ * Author:      György Kövesdi (kgy@etiner.hu)
+ * Licence:     GPL (see file 'COPYING' in the project root for more details)
+ * Comments:    sem_clockwait() is available from API level 30 only
+ *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef __OPSYS_ANDROID_THREADS_SEMAPHOREWAIT_H_INCLUDED__
+#define __OPSYS_ANDROID_THREADS_SEMAPHOREWAIT_H_INCLUDED__
+
+#include <Threads/Deadline.h>
+
+#include <semaphore.h>
+
+namespace Threads
+{
+    /// Waits for the semaphore until the deadline
+    /*! \warning    The deadline is converted to CLOCK_REALTIME, so setting the clock affects it. */
+    inline int SemaphoreWaitUntil(sem_t * semaphore, const Threads::Deadline & deadline)
+    {
+        struct timespec ts = Threads::ToRealtime(deadline);
+        return sem_timedwait(semaphore, &ts);
+    }
+
+} // namespace Threads
+
+#endif /* __OPSYS_ANDROID_THREADS_SEMAPHOREWAIT_H_INCLUDED__ */
+
+/* * * * * * * * * * * * * End - of - File * * * * * * * * * * * * * * */
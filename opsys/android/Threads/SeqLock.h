@@ -0,0 +1 @@
+../../../src/Threads/SeqLock.h
\ No newline at end of file
@@ -0,0 +1 @@
+../../../src/Threads/ThreadPool.h
\ No newline at end of file
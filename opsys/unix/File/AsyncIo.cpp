@@ -0,0 +1,460 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *
+ * Project:     My Generic C++ Library
+ * Purpose:     Asynchronous file I/O
+ * Author:      György Kövesdi (kgy@etiner.hu)
+ * Licence:     GPL (see file 'COPYING' in the project root for more details)
+ * Comments:    It uses io_uring if it is available.
+ *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include "AsyncIo.h"
+
+#include <System/SysInfo.h>
+#include <Exceptions/Exceptions.h>
+
+#include <errno.h>
+#include <string.h>
+#include <sched.h>
+#include <unistd.h>
+#include <sys/mman.h>
+
+#ifdef __linux__
+#include <sys/syscall.h>
+#ifdef __NR_io_uring_setup
+#include <linux/io_uring.h>
+#define ASYNCIO_HAS_URING
+#endif
+#endif
+
+SYS_DECLARE_MODULE(DM_FILE);
+
+using namespace FILES;
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *\
+ *                                                                                       *
+ *     class AsyncIo:                                                                    *
+ *                                                                                       *
+\* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+AsyncIo::AsyncIo(unsigned depth, Backend backend):
+    myBackend(Backend_Threads),
+    myRequests(depth ? depth : 1),
+    myFree(0),
+    mySubmitted(0),
+    myPending(0),
+    myInRing(0),
+    isClosing(false),
+    myDoneMutex("AsyncIo")
+{
+ SYS_DEBUG_MEMBER(DM_FILE);
+
+ memset(&myUring, 0, sizeof myUring);
+ myUring.fd = -1;
+
+ for (size_t i = 0; i < myRequests.size(); ++i) {
+    myRequests[i].next = i + 1 < myRequests.size() ? i + 1 : -1;
+ }
+
+ if (backend != Backend_Threads) {
+    if (SetupUring(myRequests.size())) {
+        myBackend = Backend_Uring;
+    } else if (backend == Backend_Uring) {
+        throw EX::File_Error() << "io_uring is not available: " << strerror(errno);
+    }
+ }
+
+ if (myBackend == Backend_Threads) {
+    unsigned cpus = SYS::CpuInfo::getOnlineCount();
+    myPool.reset(new Threads::ThreadPool(myRequests.size() < cpus ? myRequests.size() : cpus));
+ }
+
+ SYS_DEBUG(DL_INFO1, "Backend: " << (myBackend == Backend_Uring ? "io_uring" : "threads") << ", depth " << myRequests.size());
+}
+
+AsyncIo::~AsyncIo()
+{
+ SYS_DEBUG_MEMBER(DM_FILE);
+
+ isClosing = true;
+
+ // The queued requests are dropped, but the submitted ones can still access the buffers:
+ while (!myQueued.empty()) {
+    Complete(myQueued.front(), -ECANCELED);
+    myQueued.pop_front();
+ }
+
+ try {
+    Drain();
+ } catch (EX::Error & ex) {
+    DEBUG_OUT("AsyncIo: " << ex.what());
+ }
+
+ myPool.reset();
+
+ CloseUring();
+}
+
+void AsyncIo::Queue(Operation operation, int fd, void * buffer, size_t size, off_t offset, uint64_t tag, Callback && cb)
+{
+ ASSERT(fd >= 0, "asynchronous I/O on a closed file");
+
+ if (myFree < 0) {
+    Wait(1);
+ }
+
+ int index = myFree;
+ Request & request = myRequests[index];
+ myFree = request.next;
+
+ request.result.tag = tag;
+ request.result.operation = operation;
+ request.result.fd = fd;
+ request.result.result = 0;
+ request.area.iov_base = buffer;
+ request.area.iov_len = size;
+ request.offset = offset;
+ request.callback = std::move(cb);
+
+ myQueued.push_back(index);
+ ++myPending;
+}
+
+void AsyncIo::Complete(int index, ssize_t result)
+{
+ Request & request = myRequests[index];
+
+ request.result.result = result;
+ Completion completion = request.result;
+ Callback callback;
+ callback.swap(request.callback);
+
+ // The request is freed first, so the callback can queue new operations:
+ request.next = myFree;
+ myFree = index;
+ --myPending;
+
+ if (callback && !isClosing) {
+    callback(completion);
+ }
+}
+
+size_t AsyncIo::Submit(void)
+{
+ SYS_DEBUG_MEMBER(DM_FILE);
+
+ size_t count = myQueued.size();
+ if (!count) {
+    return 0;
+ }
+
+ SYS_DEBUG(DL_INFO2, "Submitting " << count << " operations");
+
+ if (myBackend == Backend_Threads) {
+    while (!myQueued.empty()) {
+        int index = myQueued.front();
+        myQueued.pop_front();
+        ++mySubmitted;
+        myPool->submit([this, index]() { Execute(index); });
+    }
+    return count;
+ }
+
+#ifdef ASYNCIO_HAS_URING
+ // The ring has at least as many entries as myRequests, so it cannot be full here:
+ unsigned tail = *myUring.sqTail;
+ while (!myQueued.empty()) {
+    int index = myQueued.front();
+    myQueued.pop_front();
+    const Request & request = myRequests[index];
+    unsigned slot = tail & myUring.sqMask;
+    struct io_uring_sqe & sqe = myUring.sqes[slot];
+    memset(&sqe, 0, sizeof sqe);
+    switch (request.result.operation) {
+        case Op_Read:
+            sqe.opcode = IORING_OP_READV;
+        break;
+        case Op_Write:
+            sqe.opcode = IORING_OP_WRITEV;
+        break;
+        case Op_Fsync:
+            sqe.opcode = IORING_OP_FSYNC;
+        break;
+    }
+    sqe.fd = request.result.fd;
+    sqe.off = request.offset;
+    if (request.result.operation != Op_Fsync) {
+        sqe.addr = reinterpret_cast<uintptr_t>(&request.area);
+        sqe.len = 1;
+    }
+    sqe.user_data = index;
+    myUring.sqArray[slot] = slot;
+    ++tail;
+ }
+ __atomic_store_n(myUring.sqTail, tail, __ATOMIC_RELEASE);
+
+ myInRing += count;
+ mySubmitted += count;
+
+ Enter(myInRing, 0);
+#endif
+
+ return count;
+}
+
+size_t AsyncIo::Poll(void)
+{
+ if (myBackend == Backend_Threads) {
+    return ReapThreads(0);
+ }
+
+ if (mySubmitted) {
+    // It also runs the pending kernel work of this thread, the completions may depend on it:
+    Enter(myInRing, 0);
+ }
+
+ return ReapUring();
+}
+
+size_t AsyncIo::Wait(size_t count)
+{
+ SYS_DEBUG_MEMBER(DM_FILE);
+
+ Submit();
+
+ if (count > mySubmitted) {
+    count = mySubmitted;
+ }
+
+ if (myBackend == Backend_Threads) {
+    return ReapThreads(count);
+ }
+
+ size_t done = ReapUring();
+ while (done < count) {
+    Enter(myInRing, count - done);
+    done += ReapUring();
+ }
+
+ return done;
+}
+
+void AsyncIo::Drain(void)
+{
+ while (myPending) {
+    Wait(myPending);
+ }
+}
+
+void AsyncIo::Execute(int index)
+{
+ const Request & request = myRequests[index];
+ int fd = request.result.fd;
+ void * buffer = request.area.iov_base;
+ size_t size = request.area.iov_len;
+
+ ssize_t result;
+ do {
+    switch (request.result.operation) {
+        case Op_Read:
+            result = pread(fd, buffer, size, request.offset);
+        break;
+        case Op_Write:
+            result = pwrite(fd, buffer, size, request.offset);
+        break;
+        default:
+            result = fsync(fd);
+        break;
+    }
+ } while (result < 0 && errno == EINTR);
+
+ if (result < 0) {
+    result = -errno;
+ }
+
+ Threads::Lock _l(myDoneMutex);
+ myDone.push_back(std::make_pair(index, result));
+ myDoneCondition.Signal();
+}
+
+size_t AsyncIo::ReapThreads(size_t wait)
+{
+ std::vector<std::pair<int, ssize_t> > done;
+
+ {
+    Threads::Lock _l(myDoneMutex);
+    while (myDone.size() < wait) {
+        myDoneCondition.Wait(myDoneMutex);
+    }
+    done.swap(myDone);
+ }
+
+ mySubmitted -= done.size();
+
+ for (size_t i = 0; i < done.size(); ++i) {
+    Complete(done[i].first, done[i].second);
+ }
+
+ return done.size();
+}
+
+#ifdef ASYNCIO_HAS_URING
+
+bool AsyncIo::SetupUring(unsigned depth)
+{
+ SYS_DEBUG_MEMBER(DM_FILE);
+
+ struct io_uring_params params;
+ memset(&params, 0, sizeof params);
+
+ int fd = syscall(__NR_io_uring_setup, depth, &params);
+ if (fd < 0) {
+    SYS_DEBUG(DL_INFO1, "io_uring_setup(): " << strerror(errno));
+    return false;
+ }
+
+ myUring.fd = fd;
+ myUring.sqRingSize = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+ myUring.cqRingSize = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+
+ bool single = params.features & IORING_FEAT_SINGLE_MMAP;
+ if (single && myUring.cqRingSize > myUring.sqRingSize) {
+    myUring.sqRingSize = myUring.cqRingSize;
+ }
+
+ void * sq = mmap(nullptr, myUring.sqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQ_RING);
+ if (sq == MAP_FAILED) {
+    CloseUring();
+    return false;
+ }
+ myUring.sqRing = sq;
+
+ if (single) {
+    myUring.cqRing = sq;
+ } else {
+    void * cq = mmap(nullptr, myUring.cqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_CQ_RING);
+    if (cq == MAP_FAILED) {
+        CloseUring();
+        return false;
+    }
+    myUring.cqRing = cq;
+ }
+
+ myUring.sqesSize = params.sq_entries * sizeof(struct io_uring_sqe);
+ void * sqes = mmap(nullptr, myUring.sqesSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQES);
+ if (sqes == MAP_FAILED) {
+    CloseUring();
+    return false;
+ }
+ myUring.sqes = static_cast<struct io_uring_sqe *>(sqes);
+
+ char * sqBase = static_cast<char *>(myUring.sqRing);
+ myUring.sqHead = reinterpret_cast<unsigned *>(sqBase + params.sq_off.head);
+ myUring.sqTail = reinterpret_cast<unsigned *>(sqBase + params.sq_off.tail);
+ myUring.sqMask = *reinterpret_cast<unsigned *>(sqBase + params.sq_off.ring_mask);
+ myUring.sqArray = reinterpret_cast<unsigned *>(sqBase + params.sq_off.array);
+
+ char * cqBase = static_cast<char *>(myUring.cqRing);
+ myUring.cqHead = reinterpret_cast<unsigned *>(cqBase + params.cq_off.head);
+ myUring.cqTail = reinterpret_cast<unsigned *>(cqBase + params.cq_off.tail);
+ myUring.cqMask = *reinterpret_cast<unsigned *>(cqBase + params.cq_off.ring_mask);
+ myUring.cqes = reinterpret_cast<struct io_uring_cqe *>(cqBase + params.cq_off.cqes);
+
+ SYS_DEBUG(DL_INFO1, "io_uring: " << params.sq_entries << " SQ, " << params.cq_entries << " CQ entries");
+
+ return true;
+}
+
+void AsyncIo::CloseUring(void)
+{
+ if (myUring.sqes) {
+    munmap(myUring.sqes, myUring.sqesSize);
+ }
+ if (myUring.cqRing && myUring.cqRing != myUring.sqRing) {
+    munmap(myUring.cqRing, myUring.cqRingSize);
+ }
+ if (myUring.sqRing) {
+    munmap(myUring.sqRing, myUring.sqRingSize);
+ }
+ if (myUring.fd >= 0) {
+    close(myUring.fd);
+ }
+
+ memset(&myUring, 0, sizeof myUring);
+ myUring.fd = -1;
+}
+
+size_t AsyncIo::Enter(unsigned submit, unsigned wait)
+{
+ for (;;) {
+    int result = syscall(__NR_io_uring_enter, myUring.fd, submit, wait, IORING_ENTER_GETEVENTS, nullptr, 0);
+    if (result >= 0) {
+        myInRing -= result;
+        return result;
+    }
+    switch (errno) {
+        case EINTR:
+        break;
+        case EAGAIN:
+        case EBUSY:
+            // Out of resources: the completions must be reaped first
+            if (!wait) {
+                return 0;
+            }
+            sched_yield();
+        break;
+        default:
+            throw EX::File_Error() << "io_uring_enter(): " << strerror(errno);
+        break;
+    }
+ }
+}
+
+size_t AsyncIo::ReapUring(void)
+{
+ std::vector<std::pair<int, ssize_t> > done;
+
+ unsigned head = *myUring.cqHead;
+ unsigned tail = __atomic_load_n(myUring.cqTail, __ATOMIC_ACQUIRE);
+
+ for (; head != tail; ++head) {
+    const struct io_uring_cqe & cqe = myUring.cqes[head & myUring.cqMask];
+    done.push_back(std::make_pair((int)cqe.user_data, (ssize_t)cqe.res));
+ }
+
+ __atomic_store_n(myUring.cqHead, head, __ATOMIC_RELEASE);
+
+ mySubmitted -= done.size();
+
+ for (size_t i = 0; i < done.size(); ++i) {
+    Complete(done[i].first, done[i].second);
+ }
+
+ return done.size();
+}
+
+#else
+
+bool AsyncIo::SetupUring(unsigned)
+{
+ errno = ENOSYS;
+ return false;
+}
+
+void AsyncIo::CloseUring(void)
+{
+}
+
+size_t AsyncIo::Enter(unsigned, unsigned)
+{
+ return 0;
+}
+
+size_t AsyncIo::ReapUring(void)
+{
+ return 0;
+}
+
+#endif /* ASYNCIO_HAS_URING */
+
+/* * * * * * * * * * * * * End - of - File * * * * * * * * * * * * * * */
@@ -0,0 +1,236 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *
+ * Project:     My Generic C++ Library
+ * Purpose:     Asynchronous file I/O
+ * Author:      György Kövesdi (kgy@etiner.hu)
+ * Licence:     GPL (see file 'COPYING' in the project root for more details)
+ * Comments:    It uses io_uring if it is available.
+ *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef __OPSYS_UNIX_FILE_ASYNCIO_H_INCLUDED__
+#define __OPSYS_UNIX_FILE_ASYNCIO_H_INCLUDED__
+
+#include <File/FileHandler.h>
+#include <Threads/ThreadPool.h>
+#include <Threads/DataPipe.h>
+#include <Threads/Mutex.h>
+#include <Threads/Condition.h>
+#include <Memory/Memory.h>
+#include <Debug/Debug.h>
+
+#include <functional>
+#include <vector>
+#include <deque>
+#include <stdint.h>
+#include <sys/uio.h>
+
+struct io_uring_sqe;
+struct io_uring_cqe;
+
+namespace FILES
+{
+    /// Engine for asynchronous reads, writes and fsync calls
+    /*! It uses io_uring, or pread(2)/pwrite(2) on a \ref Threads::ThreadPool if that is not available.
+     *  The callbacks are called by \ref AsyncIo::Poll(), \ref AsyncIo::Wait() or \ref AsyncIo::Drain().
+     *  \note   The object must be used from one thread only.
+     *  \warning    The buffers must be kept until the operation is completed. */
+    class AsyncIo: public MEM::noncopyable
+    {
+     public:
+        enum Backend {
+            /// io_uring if it is available, the thread pool otherwise
+            Backend_Auto,
+
+            Backend_Uring,
+
+            Backend_Threads
+        };
+
+        enum Operation {
+            Op_Read,
+            Op_Write,
+            Op_Fsync
+        };
+
+        /// The result of an operation
+        struct Completion
+        {
+            /// The value given at submission
+            uint64_t tag;
+
+            Operation operation;
+
+            int fd;
+
+            /// The number of bytes transferred (maybe less than requested), or the negative errno value
+            ssize_t result;
+
+        }; // struct FILES::AsyncIo::Completion
+
+        typedef std::function<void(const Completion &)> Callback;
+
+        /*! \param  depth   The maximum number of operations queued or in flight, the next one waits for a completion.
+         *  \throws EX::File_Error  If \ref AsyncIo::Backend_Uring is requested, but it is not available. */
+        AsyncIo(unsigned depth = 128, Backend backend = Backend_Auto);
+
+        /// Waits for the pending operations, without calling their callbacks
+        virtual ~AsyncIo();
+
+        /// Queues a read operation
+        /*! \param  tag     Any value, it is passed back in the \ref AsyncIo::Completion.
+         *  \param  cb      Called at completion, can be empty. */
+        inline void Read(const FileHandler & file, void * buffer, size_t size, off_t offset, uint64_t tag, Callback cb = Callback())
+        {
+            Queue(Op_Read, file.GetFd(), buffer, size, offset, tag, std::move(cb));
+        }
+
+        /// Queues a write operation
+        inline void Write(const FileHandler & file, const void * buffer, size_t size, off_t offset, uint64_t tag, Callback cb = Callback())
+        {
+            Queue(Op_Write, file.GetFd(), const_cast<void *>(buffer), size, offset, tag, std::move(cb));
+        }
+
+        /// Queues an fsync operation
+        /*! \note   It is not ordered to the writes, queue it after their completion. */
+        inline void Fsync(const FileHandler & file, uint64_t tag, Callback cb = Callback())
+        {
+            Queue(Op_Fsync, file.GetFd(), nullptr, 0, 0, tag, std::move(cb));
+        }
+
+        /// Starts the queued operations, returns their number
+        size_t Submit(void);
+
+        /// Calls the callbacks of the finished operations without waiting, returns their number
+        size_t Poll(void);
+
+        /// Submits the queued operations and waits for at least 'count' completions (if there are so many)
+        size_t Wait(size_t count = 1);
+
+        /// Submits and waits for all the operations
+        void Drain(void);
+
+        /// Number of operations not completed yet, including the queued ones
+        inline size_t GetPending(void) const
+        {
+            return myPending;
+        }
+
+        inline Backend GetBackend(void) const
+        {
+            return myBackend;
+        }
+
+        /// Creates a callback that stores the completions in a pipe
+        template <size_t N>
+        static inline Callback ToPipe(Threads::DataPipe<Completion, N> & pipe)
+        {
+            return [&pipe](const Completion & result) { pipe.push(result); };
+        }
+
+     private:
+        SYS_DEFINE_CLASS_NAME("FILES::AsyncIo");
+
+        /// One operation in flight
+        struct Request
+        {
+            Completion result;
+
+            struct iovec area;
+
+            off_t offset;
+
+            Callback callback;
+
+            /// Index of the next free element in \ref AsyncIo::myRequests
+            int next;
+
+        }; // struct FILES::AsyncIo::Request
+
+        void Queue(Operation operation, int fd, void * buffer, size_t size, off_t offset, uint64_t tag, Callback && cb);
+
+        /// Calls the callback and frees the request
+        void Complete(int index, ssize_t result);
+
+        /// Executes one request (thread pool backend)
+        void Execute(int index);
+
+        bool SetupUring(unsigned depth);
+
+        void CloseUring(void);
+
+        /// Calls io_uring_enter(2), returns the number of submitted entries
+        size_t Enter(unsigned submit, unsigned wait);
+
+        /// Collects the io_uring completions
+        size_t ReapUring(void);
+
+        /// Collects the thread pool completions, waits for 'wait' of them
+        size_t ReapThreads(size_t wait);
+
+        Backend myBackend;
+
+        std::vector<Request> myRequests;
+
+        /// The first free element in \ref AsyncIo::myRequests, or -1
+        int myFree;
+
+        /// The queued requests, not submitted yet
+        std::deque<int> myQueued;
+
+        /// Number of requests in flight
+        size_t mySubmitted;
+
+        /// Number of requests queued or in flight
+        size_t myPending;
+
+        /// Number of entries written to the submission ring, but not accepted by the kernel yet
+        unsigned myInRing;
+
+        /// The destructor is running, the callbacks are not called
+        bool isClosing;
+
+        /// The io_uring descriptor and mappings (Backend_Uring)
+        struct Uring
+        {
+            int fd;
+
+            void * sqRing;
+            size_t sqRingSize;
+
+            void * cqRing;
+            size_t cqRingSize;
+
+            struct io_uring_sqe * sqes;
+            size_t sqesSize;
+
+            unsigned * sqHead;
+            unsigned * sqTail;
+            unsigned sqMask;
+            unsigned * sqArray;
+
+            unsigned * cqHead;
+            unsigned * cqTail;
+            unsigned cqMask;
+            struct io_uring_cqe * cqes;
+
+        } myUring;
+
+        /// The workers (Backend_Threads)
+        MEM::shared_ptr<Threads::ThreadPool> myPool;
+
+        /// Protects \ref AsyncIo::myDone
+        Threads::Mutex myDoneMutex;
+
+        Threads::Condition myDoneCondition;
+
+        /// The requests finished by the workers: the index and the result
+        std::vector<std::pair<int, ssize_t> > myDone;
+
+    }; // class FILES::AsyncIo
+
+} // namespace FILES
+
+#endif /* __OPSYS_UNIX_FILE_ASYNCIO_H_INCLUDED__ */
+
+/* * * * * * * * * * * * * End - of - File * * * * * * * * * * * * * * */
@@ -10,6 +10,8 @@
 
 #include <errno.h>
 #include <fcntl.h>
+#include <limits.h>
+#include <vector>
 
 #include "FileHandler.h"
 
@@ -17,6 +19,24 @@ SYS_DECLARE_MODULE(DM_FILE);
 
 using namespace FILES;
 
+namespace
+{
+    /// Skips the given number of bytes in an iovec array
+    /*! The partially processed area is modified to contain the remaining part only. */
+    inline void Advance(struct iovec * & current, size_t & count, size_t done)
+    {
+        while (count && done >= current->iov_len) {
+            done -= current->iov_len;
+            ++current;
+            --count;
+        }
+        if (done) {
+            current->iov_base = static_cast<char *>(current->iov_base) + done;
+            current->iov_len -= done;
+        }
+    }
+}
+
 FileHandler::FileHandler(const DirHandler & p_dir, const char * p_filename):
     FileHandler()
 {
@@ -215,6 +235,44 @@ size_t FileHandler::Write(const void * p_data, size_t p_length)
  return p_length;
 }
 
+size_t FileHandler::WriteV(const IoVector & vec)
+{
+ SYS_DEBUG_MEMBER(DM_FILE);
+
+ if (fNo < 0) {
+    throw EX::File_Error() << "file '" << GetFullPath() << "' not opened for writing";
+ }
+
+ if (fNo == 0) {
+    throw EX::File_Error() << "Write to standard input";
+ }
+
+ if (vec.empty()) {
+    return 0;
+ }
+
+ SYS_DEBUG(DL_INFO3, "Writing " << vec.GetSize() << " bytes in " << vec.GetCount() << " areas");
+
+ // The partially written area is modified here, so a copy is needed (the areas can be split anyway):
+ std::vector<struct iovec> areas(vec.get(), vec.get() + vec.GetCount());
+
+ struct iovec * current = areas.data();
+ size_t count = areas.size();
+
+ while (count) {
+    ssize_t result = writev(fNo, current, count < IOV_MAX ? count : IOV_MAX);
+    if (result <= 0) {
+        if (RetryIo(result)) {
+            continue;
+        }
+        throw EX::File_Error() << "Error writing " << vec.GetSize() << " bytes, fd=" << fNo << "; " << (result ? strerror(errno) : "no progress");
+    }
+    Advance(current, count, result);
+ }
+
+ return vec.GetSize();
+}
+
 bool FileHandler::Read(void * p_data, size_t p_length)
 {
  SYS_DEBUG_MEMBER(DM_FILE);
@@ -262,4 +320,166 @@ do_again:;
  return true;
 }
 
+size_t FileHandler::ReadSome(void * p_data, size_t p_length)
+{
+ SYS_DEBUG_MEMBER(DM_FILE);
+
+ if (fNo < 0) {
+    throw EX::File_Error() << "file '" << GetFullPath() << "' not opened for reading";
+ }
+
+ if (fNo == 1 || fNo == 2) {
+    throw EX::File_Error() << "Read from standard out/error";
+ }
+
+ if (!p_length) {
+    return 0;
+ }
+
+ for (;;) {
+    ssize_t result = read(fNo, p_data, p_length);
+    if (result >= 0) {
+        return result;
+    }
+    switch (errno) {
+        case EINTR:
+        break;
+        case EWOULDBLOCK:
+#if EAGAIN != EWOULDBLOCK
+        case EAGAIN:
+#endif
+            BlockedIo();
+        break;
+        default:
+            throw EX::File_Error() << "Error reading " << p_length << " bytes, fd=" << fNo << "; " << strerror(errno);
+        break;
+    }
+ }
+}
+
+bool FileHandler::ReadAt(void * p_data, size_t p_length, off_t p_offset) const
+{
+ if (fNo < 0) {
+    throw EX::File_Error() << "file '" << GetFullPath() << "' not opened for reading";
+ }
+
+ char * data = static_cast<char *>(p_data);
+ size_t offset = 0;
+
+ while (offset < p_length) {
+    ssize_t result = pread(fNo, data + offset, p_length - offset, p_offset + offset);
+    if (result < 0) {
+        if (RetryIo(result)) {
+            continue;
+        }
+        throw EX::File_Error() << "Error reading " << p_length << " bytes at " << p_offset << ", fd=" << fNo << "; " << strerror(errno);
+    }
+    if (result == 0) {
+        if (offset == 0) {
+            return false;
+        }
+        throw EX::File_EOF(offset) << "EOF reached while reading " << p_length << " bytes at " << p_offset << " from '" << GetFullPath() << "', got " << offset;
+    }
+    offset += result;
+ }
+
+ return true;
+}
+
+size_t FileHandler::WriteAt(const void * p_data, size_t p_length, off_t p_offset) const
+{
+ if (fNo < 0) {
+    throw EX::File_Error() << "file '" << GetFullPath() << "' not opened for writing";
+ }
+
+ const char * data = static_cast<const char *>(p_data);
+ size_t offset = 0;
+
+ while (offset < p_length) {
+    ssize_t result = pwrite(fNo, data + offset, p_length - offset, p_offset + offset);
+    if (result <= 0) {
+        if (RetryIo(result)) {
+            continue;
+        }
+        throw EX::File_Error() << "Error writing " << p_length << " bytes at " << p_offset << ", fd=" << fNo << "; " << (result ? strerror(errno) : "no progress");
+    }
+    offset += result;
+ }
+
+ return p_length;
+}
+
+size_t FileHandler::ReadVAt(const IoVector & vec, off_t p_offset) const
+{
+ if (fNo < 0) {
+    throw EX::File_Error() << "file '" << GetFullPath() << "' not opened for reading";
+ }
+
+ std::vector<struct iovec> areas(vec.get(), vec.get() + vec.GetCount());
+ struct iovec * current = areas.data();
+ size_t count = areas.size();
+ size_t done = 0;
+
+ while (count) {
+    ssize_t result = preadv(fNo, current, count < IOV_MAX ? count : IOV_MAX, p_offset + done);
+    if (result < 0) {
+        if (RetryIo(result)) {
+            continue;
+        }
+        throw EX::File_Error() << "Error reading " << vec.GetSize() << " bytes at " << p_offset << ", fd=" << fNo << "; " << strerror(errno);
+    }
+    if (result == 0) {
+        break;
+    }
+    done += result;
+    Advance(current, count, result);
+ }
+
+ return done;
+}
+
+size_t FileHandler::WriteVAt(const IoVector & vec, off_t p_offset) const
+{
+ if (fNo < 0) {
+    throw EX::File_Error() << "file '" << GetFullPath() << "' not opened for writing";
+ }
+
+ std::vector<struct iovec> areas(vec.get(), vec.get() + vec.GetCount());
+ struct iovec * current = areas.data();
+ size_t count = areas.size();
+ size_t done = 0;
+
+ while (count) {
+    ssize_t result = pwritev(fNo, current, count < IOV_MAX ? count : IOV_MAX, p_offset + done);
+    if (result <= 0) {
+        if (RetryIo(result)) {
+            continue;
+        }
+        throw EX::File_Error() << "Error writing " << vec.GetSize() << " bytes at " << p_offset << ", fd=" << fNo << "; " << (result ? strerror(errno) : "no progress");
+    }
+    done += result;
+    Advance(current, count, result);
+ }
+
+ return done;
+}
+
+bool FileHandler::RetryIo(ssize_t result) const
+{
+ if (result < 0) {
+    switch (errno) {
+        case EINTR:
+        return true;
+        case EWOULDBLOCK:
+#if EAGAIN != EWOULDBLOCK
+        case EAGAIN:
+#endif
+            // The hook does not change the state used by the positional calls:
+            const_cast<FileHandler *>(this)->BlockedIo();
+        return true;
+    }
+ }
+ return false;
+}
+
 /* * * * * * * * * * * * * End - of - File * * * * * * * * * * * * * * */
@@ -12,6 +12,7 @@
 #define __OPSYS_UNIX_FILE_FILEHANDLER_H_INCLUDED__
 
 #include <File/Base.h>
+#include <File/IoVector.h>
 #include <File/FileFunctions.h>
 #include <File/DirHandler.h>
 
@@ -86,7 +87,35 @@ namespace FILES
         void OpenSpecial(FileMode flag);
 
         virtual bool Read(void * p_data, size_t p_length) override;
+
+        /// Reads the data available by one read(2), up to the given length, returns 0 at EOF
+        size_t ReadSome(void * p_data, size_t p_length);
+
+        /// Reads from the given position, the file position is not used
+        /*! \retval false   The position is at (or beyond) the end of the file.
+         *  \throws EX::File_EOF    If the file ends within the area. */
+        bool ReadAt(void * p_data, size_t p_length, off_t p_offset) const;
+
+        /// Writes to the given position
+        size_t WriteAt(const void * p_data, size_t p_length, off_t p_offset) const;
+
+        /// Reads to the areas of the vector from the given position, returns less only at EOF
+        size_t ReadVAt(const IoVector & vec, off_t p_offset) const;
+
+        /// Writes all the areas of the vector to the given position
+        size_t WriteVAt(const IoVector & vec, off_t p_offset) const;
+
+        template <typename T>
+        inline bool ReadAt(T & p_data, off_t p_offset) const
+        {
+            return ReadAt((void *)&p_data, sizeof(T), p_offset);
+        }
+
         virtual size_t Write(const void * p_data, size_t p_length) override;
+
+        /// Writes all the areas of the vector by writev(2), the partial writes are continued
+        virtual size_t WriteV(const IoVector & vec) override;
+
         virtual std::string GetFullPath(void) const override;
         virtual off_t Tell(void) const override;
 
@@ -97,6 +126,12 @@ namespace FILES
             return result;
         }
 
+        /// The file descriptor, or -1 if it is not opened
+        inline int GetFd(void) const
+        {
+            return fNo;
+        }
+
         inline bool Remove(void)
         {
             return FILES::Remove(GetFullPath().c_str());
@@ -135,6 +170,10 @@ namespace FILES
         SYS_DEFINE_CLASS_NAME("FILES::FileHandler");
 
         virtual void BlockedIo(void) {}
+
+        /// Handles a failed or empty result of the vectored and positional calls
+        /*! \retval true    The call can be repeated (EINTR, or EAGAIN after \ref FileHandler::BlockedIo()). */
+        bool RetryIo(ssize_t result) const;
     };
 
     class StdInput: public FileHandler
@@ -16,6 +16,9 @@
 
 namespace FILES
 {
+    /// File handler with a mutex to serialize the access
+    /*! \note   For random access, \ref FileHandler::ReadAt() and \ref FileHandler::WriteAt() need no
+     *          locking at all. */
     class FileHandlerWithLock: public FILES::FileHandler
     {
      public:
@@ -16,11 +16,83 @@ SYS_DEFINE_MODULE(DM_FILE);
 
 using namespace FILES;
 
+#ifdef __linux__
+// Note: they are supported since Linux 5.14, the older kernels return EINVAL
+#ifndef MADV_POPULATE_READ
+#define MADV_POPULATE_READ      22
+#endif
+#ifndef MADV_POPULATE_WRITE
+#define MADV_POPULATE_WRITE     23
+#endif
+#endif
+
+namespace
+{
+    /// Faults in the pages of the given area
+    /*! \param  address The start of the area, it must be page aligned. */
+    void PrefaultPages(char * address, size_t length, bool write)
+    {
+#ifdef MADV_POPULATE_READ
+        if (madvise(address, length, write ? MADV_POPULATE_WRITE : MADV_POPULATE_READ) == 0) {
+            return;
+        }
+        ASSERT_STRERROR(errno == EINVAL, "madvise(MADV_POPULATE) failed: ");
+#endif
+        // Not supported: the pages are touched one by one
+        size_t page = getpagesize();
+        for (size_t i = 0; i < length; i += page) {
+            if (write) {
+                // The mapping can be written by other threads meanwhile, so the byte must not be
+                // read and written back separately:
+                __atomic_fetch_or(address + i, 0, __ATOMIC_RELAXED);
+            } else {
+                (void)*(volatile char *)(address + i);
+            }
+        }
+    }
+
+    /// Faults in a mapping on its own thread
+    class WarmUpThread: public Threads::Thread
+    {
+     public:
+        inline WarmUpThread(char * address, size_t length, bool write):
+            Threads::Thread("map-warm-up"),
+            myAddress(address),
+            myLength(length),
+            isWrite(write)
+        {
+        }
+
+     protected:
+        virtual int main(void) override
+        {
+            // The area is processed in chunks, to be able to stop it:
+            const size_t chunk = 4 * 1024 * 1024;
+            for (size_t offset = 0; offset < myLength && !ToBeFinished(); offset += chunk) {
+                PrefaultPages(myAddress + offset, myLength - offset < chunk ? myLength - offset : chunk, isWrite);
+            }
+            return 0;
+        }
+
+     private:
+        SYS_DEFINE_CLASS_NAME("FILES::WarmUpThread");
+
+        char * myAddress;
+
+        size_t myLength;
+
+        bool isWrite;
+
+    }; // class WarmUpThread
+}
+
 FileMap::FileMap(const char * name, OpenMode mode, size_t p_size):
     fd(-1),
     mapped(nullptr),
     ende(nullptr),
-    size(0)
+    size(0),
+    myProt(PROT_READ),
+    myFlags(MAP_PRIVATE)
 {
  SYS_DEBUG_MEMBER(DM_FILE);
 
@@ -54,6 +126,13 @@ FileMap::FileMap(const char * name, OpenMode mode, size_t p_size):
         map_mode |= MAP_NONBLOCK;
     }
 
+    if (myMode & Map_Populate) {
+        map_mode |= MAP_POPULATE;
+    }
+
+    myProt = map_prot;
+    myFlags = map_mode;
+
     std::string decoded_name = FILES::DecodeName(name);
     fd = open(decoded_name.c_str(), open_mode, 0644);
 
@@ -121,6 +200,10 @@ FileMap::FileMap(FileMap && other)
  ende = other.ende;
  size = other.size;
  myMode = other.myMode;
+ myProt = other.myProt;
+ myFlags = other.myFlags;
+ myWarmUp = other.myWarmUp;
+ other.myWarmUp.reset();
 
  other.mapped = 0;
  other.ende = 0;
@@ -131,6 +214,8 @@ FileMap::~FileMap()
 {
  SYS_DEBUG_MEMBER(DM_FILE);
 
+ StopWarmUp();
+
  try {
     if (mapped && mapped != MAP_FAILED) {
         if (myMode == Read_Write) {
@@ -155,6 +240,11 @@ FileMap::~FileMap()
 
 /// Advises the kernel about how to handle paging
 void FileMap::Advise(AdviseMode mode)
+{
+ Advise(mode, 0, size);
+}
+
+void FileMap::Advise(AdviseMode mode, size_t offset, size_t length)
 {
  int mAdvise = MADV_NORMAL;
  switch (mode) {
@@ -178,7 +268,15 @@ void FileMap::Advise(AdviseMode mode)
     break;
  }
 
- ASSERT_STRERROR(madvise(mapped, size, mAdvise) == 0, "madvise() failed");
+ if (offset >= size) {
+    return;
+ }
+
+ size_t page = getpagesize();
+ size_t begin = offset / page * page;
+ size_t end = length < size - offset ? offset + length : size;
+
+ ASSERT_STRERROR(madvise(reinterpret_cast<char*>(mapped) + begin, end - begin, mAdvise) == 0, "madvise() failed");
 }
 
 bool FileMap::isOk(void) const
@@ -193,7 +291,138 @@ void FileMap::Sync(bool wait)
 
 void FileMap::Populate(void)
 {
- ASSERT_STRERROR(msync(mapped, size, MS_INVALIDATE) == 0, "msync() failed: ");
+ Prefault();
+}
+
+void FileMap::Prefault(size_t offset, size_t length, bool write)
+{
+ SYS_DEBUG_MEMBER(DM_FILE);
+
+ if (offset >= size) {
+    return;
+ }
+
+ ASSERT(!write || (myProt & PROT_WRITE), "prefaulting a read-only mapping for write, fd=" << fd);
+
+ size_t page = getpagesize();
+ size_t begin = offset / page * page;
+ size_t end = length < size - offset ? offset + length : size;
+
+ PrefaultPages(reinterpret_cast<char*>(mapped) + begin, end - begin, write);
+}
+
+void FileMap::StartWarmUp(bool write)
+{
+ SYS_DEBUG_MEMBER(DM_FILE);
+
+ StopWarmUp();
+
+ if (!size) {
+    return;
+ }
+
+ ASSERT(!write || (myProt & PROT_WRITE), "warming up a read-only mapping for write, fd=" << fd);
+
+ MEM::shared_ptr<WarmUpThread> thread(new WarmUpThread(reinterpret_cast<char*>(mapped), size, write));
+ Threads::Thread::Start(thread);
+ myWarmUp = thread;
+}
+
+void FileMap::StopWarmUp(void)
+{
+ if (myWarmUp) {
+    myWarmUp->Kill(true);
+    myWarmUp.reset();
+ }
+}
+
+bool FileMap::isWarmUpFinished(void) const
+{
+ return !myWarmUp || myWarmUp->IsFinished();
+}
+
+void FileMap::Extend(size_t new_size)
+{
+ SYS_DEBUG_MEMBER(DM_FILE);
+
+ ASSERT(fd >= 0, "extending a file which is not opened");
+ ASSERT((myMode & _OPEN_MASK) == Read_Write, "extending a read-only file, fd=" << fd);
+
+ // The warm-up thread must not touch the pages beyond the new end of the file:
+ StopWarmUp();
+
+ ASSERT_STRERROR(!ftruncate(fd, new_size), "ftruncate(" << fd << ", " << new_size << ") failed: ");
+
+ Remap(new_size);
+}
+
+bool FileMap::Refresh(void)
+{
+ if (fd < 0) {
+    return false;
+ }
+
+ struct stat sb;
+ ASSERT_STRERROR(!fstat(fd, &sb), "fstat(" << fd << ") failed: ");
+
+ if ((size_t)sb.st_size == size) {
+    return false;
+ }
+
+ SYS_DEBUG_MEMBER(DM_FILE);
+ SYS_DEBUG(DL_INFO2, "Size changed from " << size << " to " << sb.st_size);
+
+ Remap(sb.st_size);
+
+ return true;
+}
+
+void FileMap::Remap(size_t new_size)
+{
+ SYS_DEBUG_MEMBER(DM_FILE);
+
+ if (new_size == size) {
+    return;
+ }
+
+ // It uses the old mapping:
+ StopWarmUp();
+
+ void * old_address = mapped;
+ void * address;
+
+ if (!mapped) {
+    address = new_size ? mmap(nullptr, new_size, myProt, myFlags, fd, 0) : nullptr;
+ } else if (!new_size) {
+    munmap(mapped, size);
+    address = nullptr;
+ } else {
+#ifdef MREMAP_MAYMOVE
+    address = mremap(mapped, size, new_size, MREMAP_MAYMOVE);
+#else
+    munmap(mapped, size);
+    address = mmap(nullptr, new_size, myProt, myFlags, fd, 0);
+#endif
+ }
+
+ if (address == MAP_FAILED) {
+#ifndef MREMAP_MAYMOVE
+    // The old mapping has already been removed:
+    mapped = ende = nullptr;
+    size = 0;
+#endif
+    ASSERT_STRERROR(false, "Could not map fd=" << fd << " to " << new_size << " bytes: ");
+ }
+
+ mapped = address;
+ size = new_size;
+ ende = mapped ? reinterpret_cast<char*>(mapped) + size : nullptr;
+
+ SYS_DEBUG(DL_INFO2, "Remapped to " << mapped << ", " << size << " bytes");
+
+ if (mapped != old_address) {
+    Remapped(old_address);
+ }
 }
 
 /* * * * * * * * * * * * * End - of - File * * * * * * * * * * * * * * */
@@ -5,6 +5,7 @@
 #include <sys/types.h>
 
 #include <File/DirHandler.h>
+#include <Threads/Threads.h>
 #include <Debug/Debug.h>
 
 namespace FILES
@@ -19,6 +20,8 @@ namespace FILES
             Map_Shared      = 0x1000,
             Map_Nonblock    = 0x2000,
             Map_Truncate    = 0x4000,
+            /*! The whole file is read in at open (MAP_POPULATE), see also \ref FileMap::StartWarmUp() */
+            Map_Populate    = 0x8000,
             _OPEN_MASK      = 0x0fff
         };
 
@@ -70,16 +73,63 @@ namespace FILES
 
         bool isOk(void) const;
         void Advise(AdviseMode mode);
+
+        /// Advises the kernel about an area of the mapping
+        /*! \param  offset  The start of the area, it is rounded down to the page size.
+         *  \param  length  The length of the area, it is limited to the end of the mapping. */
+        void Advise(AdviseMode mode, size_t offset, size_t length);
+
         void Sync(bool wait = true);
+
+        /// Reads the whole mapping in, see \ref FileMap::Prefault()
         void Populate(void);
 
+        /// Faults the pages of an area in, by MADV_POPULATE_READ/WRITE or by touching them
+        /*! \param  write   Prepare the pages for writing too, only for writable mappings. */
+        void Prefault(size_t offset = 0, size_t length = (size_t)-1, bool write = false);
+
+        /// Starts a thread to fault in the whole mapping, the data can be used meanwhile
+        void StartWarmUp(bool write = false);
+
+        /// Stops the warm-up thread and waits for it
+        void StopWarmUp(void);
+
+        /// Checks if the warm-up thread has finished (or not started at all)
+        bool isWarmUpFinished(void) const;
+
+        /// Changes the file size and the mapping accordingly
+        /*! \warning    The mapping can be moved, the pointers to the old data become invalid. */
+        void Extend(size_t new_size);
+
+        /// Follows the size of the file, it costs one fstat(2) if it is not changed
+        /*! \retval true    The size has been changed, the mapping may have been moved. */
+        bool Refresh(void);
+
      protected:
+        /// Called when the mapping has been moved by \ref FileMap::Extend() or \ref FileMap::Refresh()
+        /*! \param  old_address The previous address of the mapping. */
+        virtual void Remapped(const void * /*old_address*/)
+        {
+        }
+
+        /// Changes the mapping to the given size, the file itself is not changed
+        void Remap(size_t new_size);
+
         int fd;
         void * mapped;
         void * ende;
         size_t size;
         OpenMode myMode;
 
+        /// The protection flags of the mapping (PROT_*)
+        int myProt;
+
+        /// The flags of the mapping (MAP_*)
+        int myFlags;
+
+        /// The thread started by \ref FileMap::StartWarmUp()
+        ThreadPtr myWarmUp;
+
      private:
         FileMap(FileMap & other);
 
@@ -0,0 +1,171 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *
+ * Project:     My Generic C++ Library
+ * Purpose:     File mapper for large and growing files
+ * Author:      György Kövesdi (kgy@etiner.hu)
+ * Licence:     GPL (see file 'COPYING' in the project root for more details)
+ * Comments:
+ *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include "FileMapWindowed.h"
+
+#include <File/Decode.h>
+#include <Exceptions/Exceptions.h>
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+SYS_DECLARE_MODULE(DM_FILE);
+
+using namespace FILES;
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *\
+ *                                                                                       *
+ *     class FileMap_windowed:                                                           *
+ *                                                                                       *
+\* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+FileMap_windowed::FileMap_windowed(const char * name, FileMap::OpenMode mode, size_t window_size, unsigned max_windows):
+    myName(FILES::DecodeName(name)),
+    myFd(-1),
+    isWritable((mode & FileMap::_OPEN_MASK) == FileMap::Read_Write),
+    mySize(0),
+    myWindowSize(window_size),
+    myMaxWindows(max_windows ? max_windows : 1),
+    myLast(0),
+    myClock(0)
+{
+ SYS_DEBUG_MEMBER(DM_FILE);
+
+ size_t page = getpagesize();
+ myWindowSize = (myWindowSize + page - 1) / page * page;
+ if (!myWindowSize) {
+    myWindowSize = page;
+ }
+
+ myFd = open(myName.c_str(), isWritable ? O_RDWR | O_CREAT : O_RDONLY, 0644);
+ ASSERT_STRERROR(myFd >= 0, "File '" << myName << "' could not be opened: ");
+
+ Refresh();
+
+ SYS_DEBUG(DL_INFO1, "Opened '" << myName << "', " << mySize << " bytes, windows of " << myWindowSize << " bytes");
+}
+
+FileMap_windowed::~FileMap_windowed()
+{
+ SYS_DEBUG_MEMBER(DM_FILE);
+
+ for (size_t i = 0; i < myWindows.size(); ++i) {
+    munmap(myWindows[i].address, myWindows[i].length);
+ }
+
+ if (myFd >= 0) {
+    close(myFd);
+ }
+}
+
+bool FileMap_windowed::Refresh(void)
+{
+ struct stat sb;
+ ASSERT_STRERROR(!fstat(myFd, &sb), "fstat('" << myName << "') failed: ");
+
+ if ((uint64_t)sb.st_size == mySize) {
+    return false;
+ }
+
+ mySize = sb.st_size;
+
+ return true;
+}
+
+void FileMap_windowed::Extend(uint64_t new_size)
+{
+ SYS_DEBUG_MEMBER(DM_FILE);
+
+ ASSERT(isWritable, "extending the read-only file '" << myName << "'");
+
+ if (new_size <= mySize) {
+    return;
+ }
+
+ ASSERT_STRERROR(!ftruncate(myFd, new_size), "ftruncate('" << myName << "', " << new_size << ") failed: ");
+
+ mySize = new_size;
+}
+
+void FileMap_windowed::Sync(bool wait)
+{
+ for (size_t i = 0; i < myWindows.size(); ++i) {
+    ASSERT_STRERROR(msync(myWindows[i].address, myWindows[i].length, wait ? MS_SYNC : MS_ASYNC) == 0, "msync() failed: ");
+ }
+}
+
+char * FileMap_windowed::Find(uint64_t offset, size_t length)
+{
+ if (offset + length > mySize) {
+    Refresh();
+    if (offset + length > mySize) {
+        size_t available = offset < mySize ? mySize - offset : 0;
+        throw EX::File_EOF(available) << "Area " << offset << "+" << length << " is beyond the end of '" << myName << "' (" << mySize << " bytes)";
+    }
+ }
+
+ for (size_t i = 0; i < myWindows.size(); ++i) {
+    Window & window = myWindows[i];
+    if (offset >= window.offset && offset + length <= window.offset + window.length) {
+        window.lastUse = ++myClock;
+        myLast = i;
+        return window.address + (offset - window.offset);
+    }
+ }
+
+ Window & window = Map(offset, length);
+
+ return window.address + (offset - window.offset);
+}
+
+FileMap_windowed::Window & FileMap_windowed::Map(uint64_t offset, size_t length)
+{
+ SYS_DEBUG_MEMBER(DM_FILE);
+
+ Window window;
+ window.offset = offset / myWindowSize * myWindowSize;
+ window.length = myWindowSize;
+ window.lastUse = ++myClock;
+
+ if (offset + length > window.offset + window.length) {
+    // The area crosses the window boundary: a larger window is mapped for it
+    size_t page = getpagesize();
+    window.length = (offset + length - window.offset + page - 1) / page * page;
+ }
+
+ if (myWindows.size() >= myMaxWindows) {
+    size_t oldest = 0;
+    for (size_t i = 1; i < myWindows.size(); ++i) {
+        if (myWindows[i].lastUse < myWindows[oldest].lastUse) {
+            oldest = i;
+        }
+    }
+    SYS_DEBUG(DL_INFO2, "Unmapping window at " << myWindows[oldest].offset);
+    munmap(myWindows[oldest].address, myWindows[oldest].length);
+    myWindows[oldest] = myWindows.back();
+    myWindows.pop_back();
+ }
+
+ // Note: the window can be longer than the file, the pages beyond its end must not be touched
+ void * address = mmap(nullptr, window.length, isWritable ? PROT_READ | PROT_WRITE : PROT_READ, MAP_SHARED, myFd, window.offset);
+ ASSERT_STRERROR(address != MAP_FAILED, "Could not map " << window.length << " bytes at " << window.offset << " of '" << myName << "': ");
+
+ SYS_DEBUG(DL_INFO2, "Mapped window at " << window.offset << ", " << window.length << " bytes");
+
+ window.address = static_cast<char *>(address);
+ myWindows.push_back(window);
+ myLast = myWindows.size() - 1;
+
+ return myWindows.back();
+}
+
+/* * * * * * * * * * * * * End - of - File * * * * * * * * * * * * * * */
@@ -0,0 +1,141 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *
+ * Project:     My Generic C++ Library
+ * Purpose:     File mapper for large and growing files
+ * Author:      György Kövesdi (kgy@etiner.hu)
+ * Licence:     GPL (see file 'COPYING' in the project root for more details)
+ * Comments:
+ *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef __OPSYS_UNIX_FILE_FILEMAPWINDOWED_H_INCLUDED__
+#define __OPSYS_UNIX_FILE_FILEMAPWINDOWED_H_INCLUDED__
+
+#include <File/Base.h>
+#include <File/FileMap.h>
+#include <Memory/Memory.h>
+#include <Debug/Debug.h>
+
+#include <vector>
+#include <string>
+#include <stdint.h>
+#include <sys/types.h>
+
+namespace FILES
+{
+    /// Maps a file in windows on demand, the least recently used window is unmapped if necessary
+    /*! The windows are shared mappings, so the appended data appears in them without remapping.
+     *  \warning    With 'max_windows' windows, at most max_windows-1 pointers can be used at the same time.
+     *  \note   It is not thread-safe. */
+    class FileMap_windowed: public MEM::noncopyable
+    {
+     public:
+        /*! \param  mode        \ref FileMap::Read_Only or \ref FileMap::Read_Write, the other flags are ignored.
+         *  \param  window_size It is rounded up to the page size. */
+        FileMap_windowed(const char * name, FileMap::OpenMode mode = FileMap::Read_Only, size_t window_size = 64*1024*1024, unsigned max_windows = 16);
+
+        inline FileMap_windowed(const std::string & name, FileMap::OpenMode mode = FileMap::Read_Only, size_t window_size = 64*1024*1024, unsigned max_windows = 16):
+            FileMap_windowed(name.c_str(), mode, window_size, max_windows)
+        {
+        }
+
+        virtual ~FileMap_windowed();
+
+        /// Returns the address of an area of the file, it can be larger than a window
+        /*! \throws EX::File_EOF    The area is beyond the end of the file, even after a refresh. */
+        inline const char * Get(uint64_t offset, size_t length)
+        {
+            return Lookup(offset, length);
+        }
+
+        /// Returns the address of an area of the file for writing
+        inline char * GetWritable(uint64_t offset, size_t length)
+        {
+            ASSERT(isWritable, "writing to a read-only mapping of '" << myName << "'");
+            return Lookup(offset, length);
+        }
+
+        /// The size of the file, as known at the last \ref FileMap_windowed::Refresh()
+        inline uint64_t GetSize(void) const
+        {
+            return mySize;
+        }
+
+        /// Reads the current size of the file, returns true if it has been changed
+        bool Refresh(void);
+
+        /// Grows the file to the given size, the windows remain valid
+        void Extend(uint64_t new_size);
+
+        /// Writes the modified pages of all the windows to the file
+        void Sync(bool wait = true);
+
+        /// Number of windows mapped at the moment
+        inline size_t GetWindowCount(void) const
+        {
+            return myWindows.size();
+        }
+
+     private:
+        SYS_DEFINE_CLASS_NAME("FILES::FileMap_windowed");
+
+        struct Window
+        {
+            char * address;
+
+            /// File offset of the window
+            uint64_t offset;
+
+            size_t length;
+
+            /// The value of \ref FileMap_windowed::myClock at the last use
+            uint64_t lastUse;
+
+        }; // struct FILES::FileMap_windowed::Window
+
+        /// Checks the last used window first
+        inline char * Lookup(uint64_t offset, size_t length)
+        {
+            if (myLast < myWindows.size() && offset + length <= mySize) {
+                Window & window = myWindows[myLast];
+                if (offset >= window.offset && offset + length <= window.offset + window.length) {
+                    window.lastUse = ++myClock;
+                    return window.address + (offset - window.offset);
+                }
+            }
+            return Find(offset, length);
+        }
+
+        /// Finds or maps the window containing the area
+        char * Find(uint64_t offset, size_t length);
+
+        /// Maps a new window, unmaps the least recently used one if necessary
+        Window & Map(uint64_t offset, size_t length);
+
+        std::string myName;
+
+        int myFd;
+
+        bool isWritable;
+
+        uint64_t mySize;
+
+        size_t myWindowSize;
+
+        unsigned myMaxWindows;
+
+        std::vector<Window> myWindows;
+
+        /// Index of the last used window, it is checked first
+        size_t myLast;
+
+        /// Counter for the LRU
+        uint64_t myClock;
+
+    }; // class FILES::FileMap_windowed
+
+} // namespace FILES
+
+#endif /* __OPSYS_UNIX_FILE_FILEMAPWINDOWED_H_INCLUDED__ */
+
+/* * * * * * * * * * * * * End - of - File * * * * * * * * * * * * * * */
@@ -16,6 +16,20 @@
 /// Forces the object to be linked in
 #define MAKE_REFERENCED __attribute__((used))
 
+/// Size of a cache line
+/*! It can be used to separate data written by different threads, to avoid false sharing. */
+#define CACHE_LINE_SIZE     64
+
+/// Tells the CPU that this is a spin-wait loop
+/*! It saves power and lets the other hyperthread run. */
+#if defined(__i386__) || defined(__x86_64__)
+#define CPU_RELAX()         __builtin_ia32_pause()
+#elif defined(__aarch64__) || defined(__arm__)
+#define CPU_RELAX()         __asm__ __volatile__("yield" ::: "memory")
+#else
+#define CPU_RELAX()         __asm__ __volatile__("" ::: "memory")
+#endif
+
 /// Increases the static initialization priority
 /*! Such a variable will be initialized before others.
     \note   It is useful only for statically initialized instances. */
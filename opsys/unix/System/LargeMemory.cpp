@@ -0,0 +1,133 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *
+ * Project:     My Generic C++ Library
+ * Purpose:     Large memory blocks on huge pages and/or on a given NUMA node
+ * Author:      György Kövesdi (kgy@etiner.hu)
+ * Licence:     GPL (see file 'COPYING' in the project root for more details)
+ * Comments:
+ *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include "LargeMemory.h"
+
+#include <System/SysInfo.h>
+#include <Exceptions/Exceptions.h>
+
+#include <stdint.h>
+#include <unistd.h>
+#include <sys/mman.h>
+
+SYS_DEFINE_MODULE(DM_SYSTEM);
+
+using SYS::LargeMemory;
+
+namespace
+{
+    inline size_t RoundUp(size_t size, size_t unit)
+    {
+        return (size + unit - 1) / unit * unit;
+    }
+}
+
+LargeMemory::LargeMemory(size_t size, PageMode mode, int node, Numa::MemPolicy policy):
+    myAddress(nullptr),
+    mySize(size),
+    myMappedSize(0),
+    myMode(mode)
+{
+ SYS_DEBUG_MEMBER(DM_SYSTEM);
+
+ if (mode != Page_Huge || !MapHuge(size)) {
+    MapNormal(size, mode == Page_Normal ? Page_Normal : Page_Transparent);
+ }
+
+ if (node >= 0 && !Numa::bindMemory(myAddress, myMappedSize, policy, node)) {
+    SYS_DEBUG(DL_WARNING, "Could not bind memory to node " << node);
+ }
+
+ SYS_DEBUG(DL_INFO1, "Allocated " << myMappedSize << " bytes, mode " << (int)myMode);
+}
+
+LargeMemory::~LargeMemory()
+{
+ if (myAddress) {
+    munmap(myAddress, myMappedSize);
+ }
+}
+
+size_t LargeMemory::getHugePageSize(void)
+{
+ static size_t size = 0;
+
+ if (!size) {
+    size_t current = 0;
+    try {
+        current = SYS::MemInfo().getMemoryHugePageSize();
+    } catch (EX::Error & ex) {
+        // Not available, see below
+    }
+    size = current ? current : 2 * 1024 * 1024;
+ }
+
+ return size;
+}
+
+bool LargeMemory::MapHuge(size_t size)
+{
+#ifdef MAP_HUGETLB
+ SYS_DEBUG_MEMBER(DM_SYSTEM);
+
+ size_t mapped = RoundUp(size, getHugePageSize());
+
+ void * address = mmap(nullptr, mapped, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+ if (address == MAP_FAILED) {
+    SYS_DEBUG(DL_INFO1, "No huge pages available for " << mapped << " bytes");
+    return false;
+ }
+
+ myAddress = address;
+ myMappedSize = mapped;
+ myMode = Page_Huge;
+
+ return true;
+#else
+ return false;
+#endif
+}
+
+void LargeMemory::MapNormal(size_t size, PageMode mode)
+{
+ size_t mapped = RoundUp(size, getpagesize());
+
+#ifdef MADV_HUGEPAGE
+ if (mode == Page_Transparent) {
+    // Align it to the huge page size, otherwise the edges cannot be huge pages:
+    size_t huge = getHugePageSize();
+    mapped = RoundUp(size, huge);
+    void * address = mmap(nullptr, mapped + huge, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    ASSERT(address != MAP_FAILED, "could not allocate " << mapped << " bytes");
+    uintptr_t begin = reinterpret_cast<uintptr_t>(address);
+    uintptr_t aligned = RoundUp(begin, huge);
+    if (aligned > begin) {
+        munmap(address, aligned - begin);
+    }
+    if (aligned + mapped < begin + mapped + huge) {
+        munmap(reinterpret_cast<void *>(aligned + mapped), begin + huge - aligned);
+    }
+    myAddress = reinterpret_cast<void *>(aligned);
+    myMappedSize = mapped;
+    // It is only an advice, the memory is usable even if it fails:
+    myMode = madvise(myAddress, myMappedSize, MADV_HUGEPAGE) == 0 ? Page_Transparent : Page_Normal;
+    return;
+ }
+#endif
+
+ void * address = mmap(nullptr, mapped, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+ ASSERT(address != MAP_FAILED, "could not allocate " << mapped << " bytes");
+
+ myAddress = address;
+ myMappedSize = mapped;
+ myMode = Page_Normal;
+}
+
+/* * * * * * * * * * * * * End - of - File * * * * * * * * * * * * * * */
@@ -0,0 +1,101 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *
+ * Project:     My Generic C++ Library
+ * Purpose:     Large memory blocks on huge pages and/or on a given NUMA node
+ * Author:      György Kövesdi (kgy@etiner.hu)
+ * Licence:     GPL (see file 'COPYING' in the project root for more details)
+ * Comments:
+ *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef __OPSYS_UNIX_SYSTEM_LARGEMEMORY_H_INCLUDED__
+#define __OPSYS_UNIX_SYSTEM_LARGEMEMORY_H_INCLUDED__
+
+#include <System/Numa.h>
+#include <Memory/Memory.h>
+#include <Debug/Debug.h>
+
+#include <stddef.h>
+
+namespace SYS
+{
+    /// Zero-filled memory block allocated directly by mmap(2), on huge pages and/or a NUMA node
+    /*! If the requested pages are not available, it falls back to the smaller ones. */
+    class LargeMemory: public MEM::noncopyable
+    {
+     public:
+        /// Page types
+        enum PageMode {
+            /// Normal pages
+            Page_Normal,
+
+            /// Normal pages, but the kernel is advised to use transparent huge pages
+            Page_Transparent,
+
+            /// Explicit huge pages
+            Page_Huge
+        };
+
+        /// Allocates the memory block
+        /*! \param  node    The NUMA node, or -1 for the default placement. */
+        LargeMemory(size_t size, PageMode mode = Page_Huge, int node = -1, Numa::MemPolicy policy = Numa::Mem_Bind);
+
+        inline LargeMemory(LargeMemory && other):
+            myAddress(other.myAddress),
+            mySize(other.mySize),
+            myMappedSize(other.myMappedSize),
+            myMode(other.myMode)
+        {
+            other.myAddress = nullptr;
+            other.mySize = other.myMappedSize = 0;
+        }
+
+        virtual ~LargeMemory();
+
+        inline void * get(void)
+        {
+            return myAddress;
+        }
+
+        inline const void * get(void) const
+        {
+            return myAddress;
+        }
+
+        /// The requested size
+        inline size_t getSize(void) const
+        {
+            return mySize;
+        }
+
+        /// The page type actually used
+        inline PageMode getMode(void) const
+        {
+            return myMode;
+        }
+
+        /// Returns the size of the huge pages, from /proc/meminfo
+        static size_t getHugePageSize(void);
+
+     private:
+        SYS_DEFINE_CLASS_NAME("SYS::LargeMemory");
+
+        bool MapHuge(size_t size);
+
+        void MapNormal(size_t size, PageMode mode);
+
+        void * myAddress;
+
+        size_t mySize;
+
+        size_t myMappedSize;
+
+        PageMode myMode;
+
+    }; // class SYS::LargeMemory
+
+} // namespace SYS
+
+#endif /* __OPSYS_UNIX_SYSTEM_LARGEMEMORY_H_INCLUDED__ */
+
+/* * * * * * * * * * * * * End - of - File * * * * * * * * * * * * * * */
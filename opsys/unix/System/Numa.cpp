@@ -0,0 +1,134 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *
+ * Project:     My Generic C++ Library
+ * Purpose:     NUMA topology and memory placement
+ * Author:      György Kövesdi (kgy@etiner.hu)
+ * Licence:     GPL (see file 'COPYING' in the project root for more details)
+ * Comments:    
+ *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include "Numa.h"
+
+#include <File/FileHandler.h>
+
+#include <string>
+#include <string.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+
+using SYS::Numa;
+
+namespace
+{
+    /// Maximum number of nodes handled here
+    const int MAX_NODES = 1024;
+
+    const size_t BITS_PER_LONG = 8 * sizeof(unsigned long);
+
+    /// Reads a small sysfs file
+    /*! \retval false   The file does not exist. */
+    bool ReadSysFile(const std::string & path, char * buffer, size_t size)
+    {
+        memset(buffer, 0, size);
+        try {
+            FILES::FileHandler file(path);
+            file.Open();
+            file.Read(buffer, size - 1);
+        } catch (EX::File_EOF & ex) {
+            // It is normal: the file is shorter than the buffer
+        } catch (EX::File_Error & ex) {
+            return false;
+        }
+        return true;
+    }
+
+    /// Node mask for the memory policy system calls
+    struct NodeMask
+    {
+        inline NodeMask(int node)
+        {
+            memset(mask, 0, sizeof mask);
+            if (node >= 0 && node < MAX_NODES) {
+                mask[node / BITS_PER_LONG] |= 1UL << (node % BITS_PER_LONG);
+            }
+        }
+
+        /// The 'maxnode' parameter of the system calls
+        /*! \note   The kernel ignores the last bit, so it is one more than the number of bits. */
+        inline unsigned long MaxNode(void) const
+        {
+            return MAX_NODES + 1;
+        }
+
+        unsigned long mask[MAX_NODES / BITS_PER_LONG];
+
+    }; // struct NodeMask
+}
+
+int Numa::getNodeCount(void)
+{
+ char buffer[256];
+
+ Threads::CpuSet nodes;     // Note: the node list has the same format as the CPU list
+ if (!ReadSysFile("/sys/devices/system/node/online", buffer, sizeof buffer) || !nodes.AddList(buffer)) {
+    return 1;
+ }
+
+ int result = 1;
+ for (int i = 0; i < CPU_SETSIZE; ++i) {
+    if (nodes.Has(i)) {
+        result = i + 1;
+    }
+ }
+
+ return result;
+}
+
+bool Numa::getNodeCpus(int node, Threads::CpuSet & cpus)
+{
+ char buffer[4096];
+
+ cpus.Clear();
+
+ if (!ReadSysFile("/sys/devices/system/node/node" + std::to_string(node) + "/cpulist", buffer, sizeof buffer)) {
+    return false;
+ }
+
+ return cpus.AddList(buffer);
+}
+
+int Numa::getCurrentNode(void)
+{
+ unsigned cpu = 0, node = 0;
+
+ if (syscall(SYS_getcpu, &cpu, &node, nullptr) != 0) {
+    return 0;
+ }
+
+ return node;
+}
+
+bool Numa::setMemoryPolicy(MemPolicy policy, int node)
+{
+ if (policy == Mem_Default) {
+    return syscall(SYS_set_mempolicy, (int)policy, nullptr, 0UL) == 0;
+ }
+
+ NodeMask mask(node);
+
+ return syscall(SYS_set_mempolicy, (int)policy, mask.mask, mask.MaxNode()) == 0;
+}
+
+bool Numa::bindMemory(void * addr, size_t length, MemPolicy policy, int node)
+{
+ if (policy == Mem_Default) {
+    return syscall(SYS_mbind, addr, length, (int)policy, nullptr, 0UL, 0U) == 0;
+ }
+
+ NodeMask mask(node);
+
+ return syscall(SYS_mbind, addr, length, (int)policy, mask.mask, mask.MaxNode(), 0U) == 0;
+}
+
+/* * * * * * * * * * * * * End - of - File * * * * * * * * * * * * * * */
@@ -0,0 +1,65 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *
+ * Project:     My Generic C++ Library
+ * Purpose:     NUMA topology and memory placement
+ * Author:      György Kövesdi (kgy@etiner.hu)
+ * Licence:     GPL (see file 'COPYING' in the project root for more details)
+ * Comments:    It uses the sysfs and the system calls directly, libnuma is not needed
+ *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef __OPSYS_UNIX_SYSTEM_NUMA_H_INCLUDED__
+#define __OPSYS_UNIX_SYSTEM_NUMA_H_INCLUDED__
+
+#include <Threads/CpuSet.h>
+#include <Debug/Debug.h>
+
+#include <stddef.h>
+
+namespace SYS
+{
+    class Numa
+    {
+     public:
+        /// Memory policies, see set_mempolicy(2)
+        enum MemPolicy {
+            /// Allocate on the node of the CPU running the thread
+            Mem_Default     = 0,
+
+            /// Prefer the given node, but fall back to others
+            Mem_Preferred   = 1,
+
+            /// Allocate only on the given node
+            Mem_Bind        = 2,
+
+            /// Interleave the pages on the given nodes
+            Mem_Interleave  = 3
+        };
+
+        /// Returns the number of NUMA nodes, 1 without NUMA information
+        static int getNodeCount(void);
+
+        /// Gets the CPUs of a node, returns false if it does not exist
+        static bool getNodeCpus(int node, Threads::CpuSet & cpus);
+
+        /// Returns the node of the CPU the calling thread is running on
+        static int getCurrentNode(void);
+
+        /// Sets the memory policy of the calling thread
+        /*! \retval false   The policy could not be set (see errno). */
+        static bool setMemoryPolicy(MemPolicy policy, int node = 0);
+
+        /// Sets the memory policy of a page-aligned memory range, for the pages allocated later
+        /*! \retval false   The policy could not be set (see errno). */
+        static bool bindMemory(void * addr, size_t length, MemPolicy policy, int node);
+
+     private:
+        SYS_DEFINE_CLASS_NAME("SYS::Numa");
+
+    }; // class SYS::Numa
+
+} // namespace SYS
+
+#endif /* __OPSYS_UNIX_SYSTEM_NUMA_H_INCLUDED__ */
+
+/* * * * * * * * * * * * * End - of - File * * * * * * * * * * * * * * */
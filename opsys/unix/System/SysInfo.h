@@ -74,6 +74,19 @@ namespace SYS
 
     }; // class SYS::MemInfo
 
+    class CpuInfo
+    {
+     public:
+        /// Returns the number of CPUs currently online
+        /*! \note   It returns at least 1, even if the number cannot be determined. */
+        inline static unsigned getOnlineCount(void)
+        {
+            long result = sysconf(_SC_NPROCESSORS_ONLN);
+            return result > 0 ? (unsigned)result : 1U;
+        }
+
+    }; // class SYS::CpuInfo
+
 } // namespace SYS
 
 #endif /* __OPSYS_UNIX_SYSTEM_SYSINFO_H_INCLUDED__ */
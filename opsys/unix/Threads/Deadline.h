@@ -0,0 +1 @@
+../../../src/Threads/Deadline.h
\ No newline at end of file
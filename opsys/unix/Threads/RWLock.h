@@ -0,0 +1 @@
+../../../generic/pthreads/Threads/RWLock.h
\ No newline at end of file
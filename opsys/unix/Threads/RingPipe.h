@@ -0,0 +1 @@
+../../../src/Threads/RingPipe.h
\ No newline at end of file
@@ -0,0 +1,32 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *
+ * Project:     My Generic C++ Library
+ * Purpose:     Timed wait for a semaphore
+ * Author:      György Kövesdi (kgy@etiner.hu)
+ * Licence:     GPL (see file 'COPYING' in the project root for more details)
+ * Comments:    See the Android version in opsys/android/Threads
+ *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef __OPSYS_UNIX_THREADS_SEMAPHOREWAIT_H_INCLUDED__
+#define __OPSYS_UNIX_THREADS_SEMAPHOREWAIT_H_INCLUDED__
+
+#include <Threads/Deadline.h>
+
+#include <semaphore.h>
+
+namespace Threads
+{
+    /// Waits for the semaphore until the deadline, on CLOCK_MONOTONIC
+    /*! \returns    The result of sem_clockwait(), see there. */
+    inline int SemaphoreWaitUntil(sem_t * semaphore, const Threads::Deadline & deadline)
+    {
+        struct timespec ts = Threads::ToMonotonic(deadline);
+        return sem_clockwait(semaphore, CLOCK_MONOTONIC, &ts);
+    }
+
+} // namespace Threads
+
+#endif /* __OPSYS_UNIX_THREADS_SEMAPHOREWAIT_H_INCLUDED__ */
+
+/* * * * * * * * * * * * * End - of - File * * * * * * * * * * * * * * */
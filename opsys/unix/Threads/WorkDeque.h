@@ -0,0 +1 @@
+../../../src/Threads/WorkDeque.h
\ No newline at end of file
@@ -84,12 +84,12 @@ Tokenizer::Tokenizer(const char * p_text, const char * p_delimiters)
 {
  SYS_DEBUG_MEMBER(DM_PARSER);
 
- myText.reset(strdup(p_text));
+ myText.assign(p_text, p_text + strlen(p_text) + 1);
 
- SYS_DEBUG(DL_VERBOSE, "To be tokenized: '" << myText.get() << "'");
+ SYS_DEBUG(DL_VERBOSE, "To be tokenized: '" << myText.data() << "'");
 
  bool inserted = false;
- for (const char * p = myText.get(); *p; ++p) {
+ for (const char * p = myText.data(); *p; ++p) {
     if (strchr(p_delimiters, *p)) {
         *const_cast<char *>(p) = 0;
         inserted = false;
@@ -13,6 +13,7 @@
 
 #include <vector>
 #include <Memory/Memory.h>
+#include <Memory/Arena.h>
 
 #include <Debug/Debug.h>
 
@@ -24,7 +25,10 @@ namespace Parser
     long long StrtollSafe(const char * p_str, int base=10);
     double StrtodSafe(const char * p_str);
 
-    class Tokenizer
+    /// Splits a string to tokens
+    /*! \note   The text and the token list are allocated from the arena of the current
+     *          \ref MEM::ArenaScope, if any. */
+    class Tokenizer: public MEM::noncopyable
     {
      public:
         static const char default_delimiters[];
@@ -44,9 +48,9 @@ namespace Parser
         }
 
      protected:
-        MEM::scoped_ptr<char> myText;
+        std::vector<char, MEM::ArenaAllocator<char> > myText;
 
-        std::vector<const char *> chunks;
+        std::vector<const char *, MEM::ArenaAllocator<const char *> > chunks;
 
      private:
         SYS_DEFINE_CLASS_NAME("Tokenizer");
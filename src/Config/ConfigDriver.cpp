@@ -224,6 +224,23 @@ int ConfDriver::yylex(yy::ConfParser::semantic_type & yylval, yy::ConfParser::lo
  int ch;
 
  do {
+     if (file) {
+         // Skip the whitespace in blocks, only the line breaks are checked one by one:
+         MEM::Span<const char> space = file->SkipSpace();
+         for (const char * p = space.begin(); p < space.end(); ++p) {
+             switch (*p) {
+                 case '\r':
+                 case '\n':
+                     ++lineNo;
+                     column = 1;
+                 break;
+                 default:
+                     ++column;
+                 break;
+             }
+         }
+     }
+
      while (isspace(ch = ChrGet())) {
          switch (ch) {
              case '\r':
@@ -335,6 +352,9 @@ int ConfDriver::lexical_analyzer(yy::ConfParser::semantic_type & yylval)
     case '#':
         // Skip the whole line until EOL:
         SYS_DEBUG(DL_INFO1, "Line " << lineNo << " is a comment");
+        if (file) {
+            column += file->ReadUntil("\r\n").size();
+        }
         while ((ch = ChrGet()) != '\r' && ch != '\n' && ch >= 0)
             ++column;
         switch (ch) {
@@ -392,8 +412,7 @@ int ConfDriver::lexical_analyzer(yy::ConfParser::semantic_type & yylval)
 \* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
 
 ConfExpression::ConfExpression(const std::string & value):
-    myValue(value),
-    reference_counter(1)
+    myValue(value)
 {
  SYS_DEBUG_MEMBER(DM_CONFIG);
 
@@ -3,6 +3,7 @@
 
 #include <File/FileMapTyped.h>
 #include <Memory/Memory.h>
+#include <Memory/Arena.h>
 #include <Debug/Debug.h>
 
 #include <map>
@@ -15,7 +16,7 @@ class ConfAssign;
 class ConfDriver;
 class ConfigLevel;
 
-typedef MEM::shared_ptr<ConfExpression> ConfigValue;
+typedef MEM::intrusive_ptr<ConfExpression> ConfigValue;
 
 #include <Config/ConfigHandler.hpp> // Generated by bison
 
@@ -34,7 +35,7 @@ class ConfigStore
 
     inline void SetConfig(AssignmentSet * assigns)
     {
-        theConfig = MEM::shared_ptr<AssignmentSet>(assigns);
+        theConfig.reset(assigns);
     }
 
     void toStream(std::ostream & os) const;
@@ -62,7 +63,7 @@ class ConfigStore
     SYS_DEFINE_CLASS_NAME("ConfigStore");
 
  protected:
-    MEM::shared_ptr<AssignmentSet> theConfig;
+    MEM::intrusive_ptr<AssignmentSet> theConfig;
 
     mutable std::string root_directory;
 
@@ -78,6 +79,8 @@ class ConfDriver
     ConfDriver(FILES::FileMap_char & file_2_parse, ConfigStore & store);
     ConfDriver(const char * data, int length, ConfigStore & store);
 
+    /// Parses the config
+    /*! \note   The nodes are allocated from the arena of the current \ref MEM::ArenaScope, if any. */
     int parse();
     void error(const yy::location & loc, const std::string & message);
     void AddError(void);
@@ -112,7 +115,7 @@ typedef MEM::shared_ptr<ConfDriver> ConfDriverPtr;
 
 static std::ostream & operator<<(std::ostream & os, const ConfExpression & ex);
 
-class ConfExpression
+class ConfExpression: public MEM::RefCounted<ConfExpression>, public MEM::ArenaObject
 {
  friend std::ostream & operator<<(std::ostream & os, const ConfExpression & ex);
 
@@ -128,24 +131,6 @@ class ConfExpression
 
     const double * ToDouble(void) const { return dValue.Value_p; }
 
-    void reference(void)
-    {
-        SYS_DEBUG_MEMBER(DM_CONFIG);
-        ++reference_counter;
-        SYS_DEBUG(DL_INFO2, "Refernced: " << reference_counter);
-    }
-
-    void unreference(void)
-    {
-        SYS_DEBUG_MEMBER(DM_CONFIG);
-        if (--reference_counter) {
-            SYS_DEBUG(DL_INFO2, "Refernced: " << reference_counter);
-            return;
-        }
-        SYS_DEBUG(DL_INFO2, "To be deleted...");
-        delete this;
-    }
-
     void Sign(void)
     {
         *iValue.Value_p = - *iValue.Value_p;
@@ -177,8 +162,6 @@ class ConfExpression
 
     Value_t<double> dValue;
 
-    int reference_counter;
-
 }; // class ConfExpression
 
 static inline std::ostream & operator<<(std::ostream & os, const ConfExpression & ex)
@@ -189,13 +172,12 @@ static inline std::ostream & operator<<(std::ostream & os, const ConfExpression
 
 static std::ostream & operator<<(std::ostream & os, const ConfAssign & as);
 
-class ConfAssign
+class ConfAssign: public MEM::ArenaObject
 {
  friend std::ostream & operator<<(std::ostream & os, const ConfAssign & as);
 
  public:
     ConfAssign(ConfigValue & name, ConfigValue & value):
-        reference_counter(1),
         myName(name),
         myValue(value)
     {
@@ -211,29 +193,9 @@ class ConfAssign
 
     ConfigValue & GetValue(void) { return myValue; }
 
-    void reference(void)
-    {
-        SYS_DEBUG_MEMBER(DM_CONFIG);
-        ++reference_counter;
-        SYS_DEBUG(DL_INFO2, "Refernced: " << reference_counter);
-    }
-
-    void unreference(void)
-    {
-        SYS_DEBUG_MEMBER(DM_CONFIG);
-        if (--reference_counter) {
-            SYS_DEBUG(DL_INFO2, "Refernced: " << reference_counter);
-            return;
-        }
-        SYS_DEBUG(DL_INFO2, "To be deleted...");
-        delete this;
-    }
-
  private:
     SYS_DEFINE_CLASS_NAME("ConfAssign");
 
-    int reference_counter;
-
     ConfigValue myName;
     ConfigValue myValue;
 
@@ -247,16 +209,15 @@ static inline std::ostream & operator<<(std::ostream & os, const ConfAssign & as
 
 static std::ostream & operator<<(std::ostream & os, const AssignmentSet & body);
 
-typedef MEM::shared_ptr<ConfigLevel> ConfPtr;
+typedef MEM::intrusive_ptr<ConfigLevel> ConfPtr;
 
-class AssignmentSet
+class AssignmentSet: public MEM::RefCounted<AssignmentSet>, public MEM::ArenaObject
 {
     friend class ConfigLevel;
     friend std::ostream & operator<<(std::ostream & os, const AssignmentSet & body);
 
  public:
-    inline AssignmentSet(void):
-        reference_counter(1)
+    inline AssignmentSet(void)
     {
         SYS_DEBUG_MEMBER(DM_CONFIG);
     }
@@ -296,24 +257,6 @@ class AssignmentSet
         return subConfigs.size();
     }
 
-    void reference(void)
-    {
-        SYS_DEBUG_MEMBER(DM_CONFIG);
-        ++reference_counter;
-        SYS_DEBUG(DL_INFO2, "Refernced: " << reference_counter);
-    }
-
-    void unreference(void)
-    {
-        SYS_DEBUG_MEMBER(DM_CONFIG);
-        if (--reference_counter) {
-            SYS_DEBUG(DL_INFO2, "Refernced: " << reference_counter);
-            return;
-        }
-        SYS_DEBUG(DL_INFO2, "To be deleted...");
-        delete this;
-    }
-
     void toStream(std::ostream & os) const;
 
     typedef std::map<std::string, ConfigValue> AssignContainer;
@@ -329,8 +272,6 @@ class AssignmentSet
 
     ConfigContainer subConfigs;
 
-    int reference_counter;
-
 }; // class AssignmentSet
 
 static inline std::ostream & operator<<(std::ostream & os, const AssignmentSet & body)
@@ -339,13 +280,12 @@ static inline std::ostream & operator<<(std::ostream & os, const AssignmentSet &
  return os;
 }
 
-class ConfigLevel
+class ConfigLevel: public MEM::RefCounted<ConfigLevel>, public MEM::ArenaObject
 {
  public:
     ConfigLevel(const std::string & name, AssignmentSet * body):
         levelName(name),
-        assignments(body),
-        reference_counter(1)
+        assignments(body)
     {
         SYS_DEBUG_MEMBER(DM_CONFIG);
         SYS_DEBUG(DL_INFO3, "New config: '" << name << "' = {" << *body << '}');
@@ -380,31 +320,11 @@ class ConfigLevel
     const ConfigValue GetConfig(const std::string & key) const;
     void toStream(std::ostream & os, int level) const;
 
-    void reference(void)
-    {
-        SYS_DEBUG_MEMBER(DM_CONFIG);
-        ++reference_counter;
-        SYS_DEBUG(DL_INFO2, "Refernced: " << reference_counter);
-    }
-
-    void unreference(void)
-    {
-        SYS_DEBUG_MEMBER(DM_CONFIG);
-        if (--reference_counter) {
-            SYS_DEBUG(DL_INFO2, "Refernced: " << reference_counter);
-            return;
-        }
-        SYS_DEBUG(DL_INFO2, "To be deleted...");
-        delete this;    // Ugly (TODO: do it in a better way)
-    }
-
  private:
     SYS_DEFINE_CLASS_NAME("ConfigLevel");
 
     std::string levelName;
-    MEM::shared_ptr<AssignmentSet> assignments;
-
-    int reference_counter;
+    MEM::intrusive_ptr<AssignmentSet> assignments;
 
 }; // class ConfigLevel
 
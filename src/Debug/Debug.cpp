@@ -73,7 +73,7 @@ map<pthread_t, DebugPrint::TabInfo> INITIALIZE_PRIORITY_HIGH DebugPrint::levels;
 
 /// Mutex for Debug Output
 /*! */
-Threads::Mutex INITIALIZE_PRIORITY_HIGH PrintLock::debugMutex;
+Threads::Mutex INITIALIZE_PRIORITY_HIGH PrintLock::debugMutex("PrintLock");
 
 /*! The DebugPrint::entering() function starts the new message with
     this string. */
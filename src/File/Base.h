@@ -47,6 +47,8 @@ namespace EX
 
 namespace FILES
 {
+    class IoVector;
+
     class Generic
     {
      public:
@@ -69,6 +71,9 @@ namespace FILES
      public:
         virtual size_t Write(const void * d, size_t size) =0;
 
+        /// Writes all the areas of the vector, by \ref Output::Write() for each area by default
+        virtual size_t WriteV(const IoVector & vec);
+
         inline Output & operator<<(const      int8_t & data) { Write(&data, sizeof data); return *this; }
         inline Output & operator<<(const     uint8_t & data) { Write(&data, sizeof data); return *this; }
         inline Output & operator<<(const     int16_t & data) { Write(&data, sizeof data); return *this; }
@@ -0,0 +1,128 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *
+ * Project:     My Generic C++ Library
+ * Purpose:     Buffered reader for binary files
+ * Author:      György Kövesdi (kgy@etiner.hu)
+ * Licence:     GPL (see file 'COPYING' in the project root for more details)
+ * Comments:
+ *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include "BinaryReader.h"
+
+SYS_DECLARE_MODULE(DM_FILE);
+
+using namespace FILES;
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *\
+ *                                                                                       *
+ *     class BinaryReader:                                                               *
+ *                                                                                       *
+\* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+BinaryReader::BinaryReader(FileHandler & file, size_t bufferSize):
+    myFile(file),
+    myBuffer(bufferSize ? bufferSize : 1),
+    myOffset(0),
+    myPosition(0),
+    myEnd(0)
+{
+}
+
+BinaryReader::~BinaryReader()
+{
+}
+
+bool BinaryReader::Read(void * p_data, size_t p_length)
+{
+ size_t available = myEnd - myPosition;
+
+ if (available >= p_length || (p_length <= myBuffer.size() && Fill(p_length))) {
+    memcpy(p_data, myBuffer.data() + myPosition, p_length);
+    myPosition += p_length;
+    return true;
+ }
+
+ // Here all the available data is less than needed, or the record is larger than the buffer:
+ available = myEnd - myPosition;
+ memcpy(p_data, myBuffer.data() + myPosition, available);
+ myOffset += myEnd;
+ myPosition = myEnd = 0;
+
+ size_t offset = available;
+ while (offset < p_length) {
+    size_t got = myFile.ReadSome(static_cast<char *>(p_data) + offset, p_length - offset);
+    if (!got) {
+        if (!offset) {
+            return false;
+        }
+        throw EX::File_EOF(offset) << "EOF reached while reading " << p_length << " bytes from '" << GetFullPath() << "', got " << offset;
+    }
+    offset += got;
+    myOffset += got;
+ }
+
+ return true;
+}
+
+void BinaryReader::Skip(uint64_t size)
+{
+ SYS_DEBUG_MEMBER(DM_FILE);
+
+ size_t available = myEnd - myPosition;
+
+ if (available >= size) {
+    myPosition += size;
+    return;
+ }
+
+ size -= available;
+ myOffset += myEnd;
+ myPosition = myEnd = 0;
+
+ while (size) {
+    size_t got = myFile.ReadSome(myBuffer.data(), size < myBuffer.size() ? size : myBuffer.size());
+    if (!got) {
+        throw EX::File_EOF(0) << "EOF reached while skipping in '" << GetFullPath() << "', " << size << " bytes are missing";
+    }
+    size -= got;
+    myOffset += got;
+ }
+}
+
+bool BinaryReader::Fill(size_t size)
+{
+ SYS_DEBUG_MEMBER(DM_FILE);
+
+ if (myPosition + size > myBuffer.size()) {
+    // Move the unconsumed data to the beginning:
+    memmove(myBuffer.data(), myBuffer.data() + myPosition, myEnd - myPosition);
+    myOffset += myPosition;
+    myEnd -= myPosition;
+    myPosition = 0;
+    if (size > myBuffer.size()) {
+        SYS_DEBUG(DL_INFO2, "Buffer grows for " << size << " bytes");
+        myBuffer.resize(size > 2 * myBuffer.size() ? size : 2 * myBuffer.size());
+    }
+ }
+
+ while (myEnd - myPosition < size) {
+    size_t got = myFile.ReadSome(myBuffer.data() + myEnd, myBuffer.size() - myEnd);
+    if (!got) {
+        SYS_DEBUG(DL_INFO2, "EOF: " << myEnd - myPosition << " bytes available instead of " << size);
+        return false;
+    }
+    myEnd += got;
+ }
+
+ return true;
+}
+
+void BinaryReader::Require(size_t size)
+{
+ if (!Fill(size)) {
+    throw EX::File_EOF(myEnd - myPosition) << "EOF reached while reading " << size << " bytes from '" << GetFullPath() << "', got " << myEnd - myPosition;
+ }
+}
+
+/* * * * * * * * * * * * * End - of - File * * * * * * * * * * * * * * */
@@ -0,0 +1,134 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *
+ * Project:     My Generic C++ Library
+ * Purpose:     Buffered reader for binary files
+ * Author:      György Kövesdi (kgy@etiner.hu)
+ * Licence:     GPL (see file 'COPYING' in the project root for more details)
+ * Comments:
+ *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef __SRC_FILE_BINARYREADER_H_INCLUDED__
+#define __SRC_FILE_BINARYREADER_H_INCLUDED__
+
+#include <File/FileHandler.h>
+#include <Memory/Memory.h>
+#include <Memory/Span.h>
+
+#include <vector>
+#include <type_traits>
+#include <string.h>
+#include <stdint.h>
+
+namespace FILES
+{
+    /// Reader for binary streams, the data is accessed in the internal buffer
+    /*! \warning    The views are valid only until the next operation which reads the file. */
+    class BinaryReader: public FILES::Input, public MEM::noncopyable
+    {
+     public:
+        typedef MEM::Span<const char> Span;
+
+        /*! \param  file        It must have been opened.
+         *  \param  bufferSize  The initial size, it grows for larger areas. */
+        BinaryReader(FileHandler & file, size_t bufferSize = 1024 * 1024);
+        virtual ~BinaryReader();
+
+        /// Returns the next 'size' bytes without consuming them, less only at EOF
+        inline Span Peek(size_t size)
+        {
+            if (myEnd - myPosition < size) {
+                Fill(size);
+            }
+            size_t available = myEnd - myPosition;
+            return Span(myBuffer.data() + myPosition, available < size ? available : size);
+        }
+
+        /// Returns and consumes the next 'size' bytes
+        /*! \throws EX::File_EOF    If the file has less data. */
+        inline Span Consume(size_t size)
+        {
+            if (myEnd - myPosition < size) {
+                Require(size);
+            }
+            Span result(myBuffer.data() + myPosition, size);
+            myPosition += size;
+            return result;
+        }
+
+        /// Copies a fixed-size record, it need not be aligned in the file
+        /*! \retval false   EOF before the record.
+         *  \throws EX::File_EOF    If the record is incomplete. */
+        template <typename T>
+        inline bool Read(T & record)
+        {
+            static_assert(std::is_trivially_copyable<T>::value, "only trivially copyable records can be read directly");
+            return Read(&record, sizeof record);
+        }
+
+        virtual bool Read(void * p_data, size_t p_length) override;
+
+        /// Reads an area prefixed by its length, stored as 'Length' in native byte order
+        /*! \retval false   EOF before the length.
+         *  \throws EX::File_EOF    If the area is incomplete. */
+        template <typename Length = uint32_t>
+        inline bool ReadBlob(Span & blob)
+        {
+            Length length;
+            if (!Read(length)) {
+                return false;
+            }
+            blob = Consume(length);
+            return true;
+        }
+
+        /// Skips the given number of bytes
+        /*! \throws EX::File_EOF    If the file has less data. */
+        void Skip(uint64_t size);
+
+        /// Checks if all the data has been consumed
+        inline bool eof(void)
+        {
+            return myPosition == myEnd && !Fill(1);
+        }
+
+        /// Number of bytes consumed from the beginning
+        virtual off_t Tell(void) const override
+        {
+            return myOffset + myPosition;
+        }
+
+        virtual std::string GetFullPath(void) const override
+        {
+            return myFile.GetFullPath();
+        }
+
+     private:
+        SYS_DEFINE_CLASS_NAME("FILES::BinaryReader");
+
+        /// Reads data until 'size' bytes are available, returns false at EOF
+        bool Fill(size_t size);
+
+        /// Reads data until 'size' bytes are available, throws EX::File_EOF if it is not possible
+        void Require(size_t size);
+
+        FileHandler & myFile;
+
+        std::vector<char> myBuffer;
+
+        /// The file offset of the beginning of \ref BinaryReader::myBuffer
+        uint64_t myOffset;
+
+        /// The first unconsumed byte
+        size_t myPosition;
+
+        /// The end of the valid data
+        size_t myEnd;
+
+    }; // class FILES::BinaryReader
+
+} // namespace FILES
+
+#endif /* __SRC_FILE_BINARYREADER_H_INCLUDED__ */
+
+/* * * * * * * * * * * * * End - of - File * * * * * * * * * * * * * * */
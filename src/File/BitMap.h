@@ -12,6 +12,8 @@
 #define __BASELIB_SRC_FILE_BITMAP_H_INCLUDED__
 
 #include <File/FileMap.h>
+#include <File/BitOps.h>
+#include <System/Generic.h>
 #include <Memory/InlineData.h>
 #include <Exceptions/Exceptions.h>
 
@@ -25,9 +27,14 @@
  *                                                                                       *
 \* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
 
+/// Bit array on the storage given by ALLOC
+/*! The bulk operations work on whole words, see \ref FILES::BitOps. */
 template <size_t BITS, class ALLOC>
 class BitMapBase: public ALLOC
 {
+    template <size_t, class>
+    friend class BitMapBase;
+
  public:
     static constexpr size_t BYTES   =   (BITS+7)/8;
 
@@ -85,25 +92,89 @@ class BitMapBase: public ALLOC
 
     inline bool operator[](size_t index) const
     {
-        ASSERT(index <= BITS, "index overflow in BitMapBase::operator[] (index=" << index << ", allocated=" << BITS << " bits)");
+        ASSERT(index < BITS, "index overflow in BitMapBase::operator[] (index=" << index << ", allocated=" << BITS << " bits)");
         bitMask m(index);
         return getMyData()[m.offset] & m.mask();
     }
 
     inline void set(size_t index)
     {
-        ASSERT(index <= BITS, "index overflow in BitMapBase::set() (index=" << index << ", allocated=" << BITS << " bits)");
+        ASSERT(index < BITS, "index overflow in BitMapBase::set() (index=" << index << ", allocated=" << BITS << " bits)");
         bitMask m(index);
         getMyData()[m.offset] |= m.mask();
     }
 
     inline void clear(size_t index)
     {
-        ASSERT(index <= BITS, "index overflow in BitMapBase::clear() (index=" << index << ", allocated=" << BITS << " bits)");
+        ASSERT(index < BITS, "index overflow in BitMapBase::clear() (index=" << index << ", allocated=" << BITS << " bits)");
         bitMask m(index);
         getMyData()[m.offset] &= ~m.mask();
     }
 
+    /// Sets the bits in the range [begin, end)
+    inline void set(size_t begin, size_t end)
+    {
+        ASSERT(begin <= end && end <= BITS, "invalid range in BitMapBase::set() (range=" << begin << "-" << end << ", allocated=" << BITS << " bits)");
+        FILES::BitOps::SetRange(getMyData(), begin, end);
+    }
+
+    /// Clears the bits in the range [begin, end)
+    inline void clear(size_t begin, size_t end)
+    {
+        ASSERT(begin <= end && end <= BITS, "invalid range in BitMapBase::clear() (range=" << begin << "-" << end << ", allocated=" << BITS << " bits)");
+        FILES::BitOps::ClearRange(getMyData(), begin, end);
+    }
+
+    /// Number of the bits set
+    inline size_t count(void) const
+    {
+        return FILES::BitOps::Count(getMyData(), BITS);
+    }
+
+    /// Finds the first bit set, starting from the given index, or returns BITS
+    inline size_t find_set(size_t from = 0) const
+    {
+        return FILES::BitOps::FindFirstSet(getMyData(), from, BITS);
+    }
+
+    /// Finds the first bit cleared, starting from the given index, or returns BITS
+    inline size_t find_clear(size_t from = 0) const
+    {
+        return FILES::BitOps::FindFirstClear(getMyData(), from, BITS);
+    }
+
+    /// Intersection
+    template <class A>
+    inline BitMapBase & operator&=(const BitMapBase<BITS, A> & other)
+    {
+        FILES::BitOps::And(getMyData(), other.getMyData(), BYTES);
+        return *this;
+    }
+
+    /// Union
+    template <class A>
+    inline BitMapBase & operator|=(const BitMapBase<BITS, A> & other)
+    {
+        FILES::BitOps::Or(getMyData(), other.getMyData(), BYTES);
+        return *this;
+    }
+
+    /// Symmetric difference
+    template <class A>
+    inline BitMapBase & operator^=(const BitMapBase<BITS, A> & other)
+    {
+        FILES::BitOps::Xor(getMyData(), other.getMyData(), BYTES);
+        return *this;
+    }
+
+    /// Difference: clears the bits which are set in the other bitmap
+    template <class A>
+    inline BitMapBase & and_not(const BitMapBase<BITS, A> & other)
+    {
+        FILES::BitOps::AndNot(getMyData(), other.getMyData(), BYTES);
+        return *this;
+    }
+
 } PACKED; // class BitMapBase<>
 
 /* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *\
@@ -0,0 +1,338 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *
+ * Project:     My Generic C++ Library
+ * Purpose:     Word-level operations on bit arrays
+ * Author:      György Kövesdi (kgy@etiner.hu)
+ * Licence:     GPL (see file 'COPYING' in the project root for more details)
+ * Comments:    SSE2/AVX2 is used on x86, selected at runtime.
+ *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include "BitOps.h"
+
+#include <string.h>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || (defined(__i386__) && defined(__SSE2__)))
+#define BITOPS_X86
+#include <immintrin.h>
+#endif
+
+using namespace FILES;
+
+namespace
+{
+    typedef size_t (*CountFunction)(const uint8_t * data, size_t bytes);
+
+    typedef void (*LogicFunction)(uint8_t * dst, const uint8_t * src, size_t bytes);
+
+    /// Loads 8 bytes in the bit order of \ref FILES::BitOps
+    inline uint64_t LoadWord(const uint8_t * data)
+    {
+        uint64_t word;
+        memcpy(&word, data, sizeof(word));
+#if __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+        word = __builtin_bswap64(word);
+#endif
+        return word;
+    }
+
+    // The operators below work on the integer types, and on the vector types of GCC as well:
+
+    struct OpAnd
+    {
+        template <typename T>
+        static inline __attribute__((always_inline)) void Apply(T & a, const T & b)
+        {
+            a &= b;
+        }
+    };
+
+    struct OpOr
+    {
+        template <typename T>
+        static inline __attribute__((always_inline)) void Apply(T & a, const T & b)
+        {
+            a |= b;
+        }
+    };
+
+    struct OpXor
+    {
+        template <typename T>
+        static inline __attribute__((always_inline)) void Apply(T & a, const T & b)
+        {
+            a ^= b;
+        }
+    };
+
+    struct OpAndNot
+    {
+        template <typename T>
+        static inline __attribute__((always_inline)) void Apply(T & a, const T & b)
+        {
+            a &= ~b;
+        }
+    };
+
+    template <class OP>
+    inline __attribute__((always_inline)) void LogicWords(uint8_t * dst, const uint8_t * src, size_t bytes)
+    {
+        size_t i = 0;
+        for (; i + 8 <= bytes; i += 8) {
+            uint64_t a, b;
+            memcpy(&a, dst + i, sizeof(a));
+            memcpy(&b, src + i, sizeof(b));
+            OP::Apply(a, b);
+            memcpy(dst + i, &a, sizeof(a));
+        }
+        for (; i < bytes; ++i) {
+            OP::Apply(dst[i], src[i]);
+        }
+    }
+
+    template <class OP>
+    void LogicScalar(uint8_t * dst, const uint8_t * src, size_t bytes)
+    {
+        LogicWords<OP>(dst, src, bytes);
+    }
+
+    inline __attribute__((always_inline)) size_t CountWords(const uint8_t * data, size_t bytes)
+    {
+        size_t result = 0;
+        size_t i = 0;
+        for (; i + 8 <= bytes; i += 8) {
+            result += __builtin_popcountll(LoadWord(data + i));
+        }
+        for (; i < bytes; ++i) {
+            result += __builtin_popcount(data[i]);
+        }
+        return result;
+    }
+
+    size_t CountScalar(const uint8_t * data, size_t bytes)
+    {
+        return CountWords(data, bytes);
+    }
+
+#ifdef BITOPS_X86
+
+    template <class OP>
+    void LogicSse2(uint8_t * dst, const uint8_t * src, size_t bytes)
+    {
+        size_t i = 0;
+        for (; i + 16 <= bytes; i += 16) {
+            __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i *>(dst + i));
+            __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i));
+            OP::Apply(a, b);
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + i), a);
+        }
+        LogicWords<OP>(dst + i, src + i, bytes - i);
+    }
+
+    template <class OP>
+    __attribute__((target("avx2")))
+    void LogicAvx2(uint8_t * dst, const uint8_t * src, size_t bytes)
+    {
+        size_t i = 0;
+        for (; i + 32 <= bytes; i += 32) {
+            __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(dst + i));
+            __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(src + i));
+            OP::Apply(a, b);
+            _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst + i), a);
+        }
+        LogicWords<OP>(dst + i, src + i, bytes - i);
+    }
+
+    __attribute__((target("popcnt")))
+    size_t CountPopcnt(const uint8_t * data, size_t bytes)
+    {
+        return CountWords(data, bytes);
+    }
+
+    /// Counts the bits by nibble lookup, see Mula, Kurz, Lemire: "Faster Population Counts Using AVX2 Instructions"
+    __attribute__((target("avx2,popcnt")))
+    size_t CountAvx2(const uint8_t * data, size_t bytes)
+    {
+        const __m256i lookup = _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+                                                0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+        const __m256i nibble = _mm256_set1_epi8(0x0f);
+        const __m256i zero = _mm256_setzero_si256();
+        __m256i total = zero;
+        size_t i = 0;
+        while (i + 32 <= bytes) {
+            // The byte counters can hold the sum of at most 31 blocks (31 * 8 < 256):
+            __m256i partial = zero;
+            for (int n = 0; n < 31 && i + 32 <= bytes; ++n, i += 32) {
+                __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(data + i));
+                __m256i low = _mm256_shuffle_epi8(lookup, _mm256_and_si256(block, nibble));
+                __m256i high = _mm256_shuffle_epi8(lookup, _mm256_and_si256(_mm256_srli_epi16(block, 4), nibble));
+                partial = _mm256_add_epi8(partial, _mm256_add_epi8(low, high));
+            }
+            total = _mm256_add_epi64(total, _mm256_sad_epu8(partial, zero));
+        }
+        size_t result = _mm256_extract_epi64(total, 0) + _mm256_extract_epi64(total, 1) +
+                        _mm256_extract_epi64(total, 2) + _mm256_extract_epi64(total, 3);
+        return result + CountWords(data + i, bytes - i);
+    }
+
+#endif /* BITOPS_X86 */
+
+    struct Implementation
+    {
+        const char * name;
+
+        CountFunction count;
+
+        LogicFunction logicAnd;
+
+        LogicFunction logicOr;
+
+        LogicFunction logicXor;
+
+        LogicFunction logicAndNot;
+
+    }; // struct Implementation
+
+#define BITOPS_IMPLEMENTATION(name, count, logic)  { name, &count, &logic<OpAnd>, &logic<OpOr>, &logic<OpXor>, &logic<OpAndNot> }
+
+    Implementation SelectImplementation(void)
+    {
+#ifdef BITOPS_X86
+        static const Implementation avx2 = BITOPS_IMPLEMENTATION("avx2", CountAvx2, LogicAvx2);
+        static const Implementation popcnt = BITOPS_IMPLEMENTATION("popcnt", CountPopcnt, LogicSse2);
+        static const Implementation sse2 = BITOPS_IMPLEMENTATION("sse2", CountScalar, LogicSse2);
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("popcnt")) {
+            return avx2;
+        }
+        return __builtin_cpu_supports("popcnt") ? popcnt : sse2;
+#else
+        static const Implementation scalar = BITOPS_IMPLEMENTATION("scalar", CountScalar, LogicScalar);
+        return scalar;
+#endif
+    }
+
+#undef BITOPS_IMPLEMENTATION
+
+    /// Returns the implementation selected for this CPU
+    /*! \note   It is not a global variable, because it can be used by static constructors too. */
+    inline const Implementation & GetImpl(void)
+    {
+        static const Implementation impl = SelectImplementation();
+        return impl;
+    }
+
+    /// Finds the first bit in [from, bits) which differs from 'skip'
+    size_t Find(const uint8_t * data, size_t from, size_t bits, bool skip)
+    {
+        if (from >= bits) {
+            return bits;
+        }
+        const uint64_t invert = skip ? ~(uint64_t)0 : 0;
+        const size_t bytes = (bits + 7) / 8;
+        size_t result = bits;
+
+        // The first, partial byte:
+        size_t i = from / 8;
+        unsigned first = (uint8_t)(data[i] ^ invert) & (0xffu << (from % 8));
+        if (first) {
+            result = i * 8 + __builtin_ctz(first);
+        } else {
+            for (++i; i + 8 <= bytes; i += 8) {
+                uint64_t word = LoadWord(data + i) ^ invert;
+                if (word) {
+                    result = i * 8 + __builtin_ctzll(word);
+                    break;
+                }
+            }
+            if (result == bits) {
+                for (; i < bytes; ++i) {
+                    unsigned byte = (uint8_t)(data[i] ^ invert);
+                    if (byte) {
+                        result = i * 8 + __builtin_ctz(byte);
+                        break;
+                    }
+                }
+            }
+        }
+
+        // The unused bits of the last byte are not part of the array:
+        return result < bits ? result : bits;
+    }
+
+    void Fill(uint8_t * data, size_t begin, size_t end, bool value)
+    {
+        if (begin >= end) {
+            return;
+        }
+        size_t first = begin / 8;
+        size_t last = (end - 1) / 8;
+        uint8_t head = 0xff << (begin % 8);
+        uint8_t tail = 0xff >> (7 - (end - 1) % 8);
+        if (first == last) {
+            head &= tail;
+        }
+        data[first] = value ? (data[first] | head) : (data[first] & ~head);
+        if (first == last) {
+            return;
+        }
+        memset(data + first + 1, value ? 0xff : 0, last - first - 1);
+        data[last] = value ? (data[last] | tail) : (data[last] & ~tail);
+    }
+}
+
+size_t BitOps::Count(const uint8_t * data, size_t bits)
+{
+ size_t result = GetImpl().count(data, bits / 8);
+ if (bits % 8) {
+    result += __builtin_popcount(data[bits / 8] & ((1u << (bits % 8)) - 1));
+ }
+ return result;
+}
+
+size_t BitOps::FindFirstSet(const uint8_t * data, size_t from, size_t bits)
+{
+ return Find(data, from, bits, false);
+}
+
+size_t BitOps::FindFirstClear(const uint8_t * data, size_t from, size_t bits)
+{
+ return Find(data, from, bits, true);
+}
+
+void BitOps::SetRange(uint8_t * data, size_t begin, size_t end)
+{
+ Fill(data, begin, end, true);
+}
+
+void BitOps::ClearRange(uint8_t * data, size_t begin, size_t end)
+{
+ Fill(data, begin, end, false);
+}
+
+void BitOps::And(uint8_t * dst, const uint8_t * src, size_t bytes)
+{
+ GetImpl().logicAnd(dst, src, bytes);
+}
+
+void BitOps::Or(uint8_t * dst, const uint8_t * src, size_t bytes)
+{
+ GetImpl().logicOr(dst, src, bytes);
+}
+
+void BitOps::Xor(uint8_t * dst, const uint8_t * src, size_t bytes)
+{
+ GetImpl().logicXor(dst, src, bytes);
+}
+
+void BitOps::AndNot(uint8_t * dst, const uint8_t * src, size_t bytes)
+{
+ GetImpl().logicAndNot(dst, src, bytes);
+}
+
+const char * BitOps::GetImplementation(void)
+{
+ return GetImpl().name;
+}
+
+/* * * * * * * * * * * * * End - of - File * * * * * * * * * * * * * * */
@@ -0,0 +1,59 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *
+ * Project:     My Generic C++ Library
+ * Purpose:     Word-level operations on bit arrays
+ * Author:      György Kövesdi (kgy@etiner.hu)
+ * Licence:     GPL (see file 'COPYING' in the project root for more details)
+ * Comments:    SSE2/AVX2 is used on x86, selected at runtime.
+ *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef __SRC_FILE_BITOPS_H_INCLUDED__
+#define __SRC_FILE_BITOPS_H_INCLUDED__
+
+#include <stddef.h>
+#include <stdint.h>
+
+namespace FILES
+{
+    /// Operations on unaligned bit arrays, as used by \ref BitMapBase
+    /*! The bit 'n' is the bit (n % 8) of the byte (n / 8). */
+    namespace BitOps
+    {
+        /// Number of the bits set in [0, bits)
+        size_t Count(const uint8_t * data, size_t bits);
+
+        /// Finds the first bit set in [from, bits), or returns 'bits'
+        size_t FindFirstSet(const uint8_t * data, size_t from, size_t bits);
+
+        /// Finds the first bit cleared in [from, bits), or returns 'bits'
+        size_t FindFirstClear(const uint8_t * data, size_t from, size_t bits);
+
+        /// Sets the bits in [begin, end)
+        void SetRange(uint8_t * data, size_t begin, size_t end);
+
+        /// Clears the bits in [begin, end)
+        void ClearRange(uint8_t * data, size_t begin, size_t end);
+
+        /// dst &= src, on 'bytes' bytes
+        void And(uint8_t * dst, const uint8_t * src, size_t bytes);
+
+        /// dst |= src, on 'bytes' bytes
+        void Or(uint8_t * dst, const uint8_t * src, size_t bytes);
+
+        /// dst ^= src, on 'bytes' bytes
+        void Xor(uint8_t * dst, const uint8_t * src, size_t bytes);
+
+        /// dst &= ~src, on 'bytes' bytes
+        void AndNot(uint8_t * dst, const uint8_t * src, size_t bytes);
+
+        /// The name of the implementation selected for this CPU: "avx2", "popcnt", "sse2" or "scalar"
+        const char * GetImplementation(void);
+
+    } // namespace FILES::BitOps
+
+} // namespace FILES
+
+#endif /* __SRC_FILE_BITOPS_H_INCLUDED__ */
+
+/* * * * * * * * * * * * * End - of - File * * * * * * * * * * * * * * */
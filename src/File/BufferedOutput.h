@@ -0,0 +1,129 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *
+ * Project:     My Generic C++ Library
+ * Purpose:     Output adapter to collect small writes
+ * Author:      György Kövesdi (kgy@etiner.hu)
+ * Licence:     GPL (see file 'COPYING' in the project root for more details)
+ * Comments:
+ *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef __SRC_FILE_BUFFEREDOUTPUT_H_INCLUDED__
+#define __SRC_FILE_BUFFEREDOUTPUT_H_INCLUDED__
+
+#include <File/Base.h>
+#include <File/IoVector.h>
+#include <Memory/Memory.h>
+#include <Exceptions/Exceptions.h>
+#include <Debug/Debug.h>
+
+#include <string.h>
+
+namespace FILES
+{
+    /// Buffer for many small writes
+    /*! The large areas are not copied, they are written together with the buffered data by one
+     *  \ref FILES::Output::WriteV() call.
+     *  \note   The destructor cannot report the errors, call \ref BufferedOutput::Flush() explicitly. */
+    template <size_t BufferSize = 65536>
+    class BufferedOutput: public FILES::Output, public MEM::noncopyable
+    {
+     public:
+        inline BufferedOutput(FILES::Output & target):
+            myTarget(target),
+            myUsed(0)
+        {
+        }
+
+        virtual ~BufferedOutput()
+        {
+            try {
+                Flush();
+            } catch (EX::Error & ex) {
+                DEBUG_OUT("Could not flush '" << GetFullPath() << "': " << ex.what());
+            }
+        }
+
+        virtual size_t Write(const void * d, size_t size) override
+        {
+            if (size <= BufferSize - myUsed) {
+                memcpy(myBuffer + myUsed, d, size);
+                myUsed += size;
+                return size;
+            }
+            if (size >= BufferSize) {
+                // Too large to be copied: one write for the buffer and the data
+                IoVector vec;
+                vec.Add(myBuffer, myUsed).Add(d, size);
+                myTarget.WriteV(vec);
+                myUsed = 0;
+                return size;
+            }
+            Flush();
+            memcpy(myBuffer, d, size);
+            myUsed = size;
+            return size;
+        }
+
+        /// Collects the small areas, the large ones are passed to the target without copy
+        virtual size_t WriteV(const IoVector & vec) override
+        {
+            if (vec.GetSize() <= BufferSize - myUsed) {
+                for (size_t i = 0; i < vec.GetCount(); ++i) {
+                    memcpy(myBuffer + myUsed, vec[i].iov_base, vec[i].iov_len);
+                    myUsed += vec[i].iov_len;
+                }
+                return vec.GetSize();
+            }
+            IoVector merged;
+            merged.Add(myBuffer, myUsed);
+            for (size_t i = 0; i < vec.GetCount(); ++i) {
+                merged.Add(vec[i].iov_base, vec[i].iov_len);
+            }
+            myTarget.WriteV(merged);
+            myUsed = 0;
+            return vec.GetSize();
+        }
+
+        /// Writes the buffered data to the target
+        inline void Flush(void)
+        {
+            if (myUsed) {
+                size_t size = myUsed;
+                myUsed = 0;
+                myTarget.Write(myBuffer, size);
+            }
+        }
+
+        /// Number of bytes waiting in the buffer
+        inline size_t GetBuffered(void) const
+        {
+            return myUsed;
+        }
+
+        /// The position as if the buffer was flushed
+        virtual off_t Tell(void) const override
+        {
+            return myTarget.Tell() + myUsed;
+        }
+
+        virtual std::string GetFullPath(void) const override
+        {
+            return myTarget.GetFullPath();
+        }
+
+     private:
+        FILES::Output & myTarget;
+
+        /// Number of bytes used in \ref BufferedOutput::myBuffer
+        size_t myUsed;
+
+        char myBuffer[BufferSize];
+
+    }; // class FILES::BufferedOutput
+
+} // namespace FILES
+
+#endif /* __SRC_FILE_BUFFEREDOUTPUT_H_INCLUDED__ */
+
+/* * * * * * * * * * * * * End - of - File * * * * * * * * * * * * * * */
@@ -16,6 +16,7 @@
 namespace FILES
 {
     /// File handler class optimized for reading byte-by-byte
+    /*! \see   FILES::BinaryReader for records and larger areas. */
     template <unsigned BufferSize = 4096>
     class BufferedReader
     {
@@ -60,6 +61,8 @@ namespace FILES
             try {
                 if (!myFile.Read(myBuffer)) {
                     SYS_DEBUG(DL_INFO1, "Really EOF");
+                    // Note: the buffer contains the previous block, it must not be read again:
+                    myLastChar = 0;
                     return EOF;
                 }
                 myLastChar = sizeof(myBuffer) - 1;
@@ -0,0 +1,236 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *
+ * Project:     My Generic C++ Library
+ * Purpose:     Growable memory buffer made of segments
+ * Author:      György Kövesdi (kgy@etiner.hu)
+ * Licence:     GPL (see file 'COPYING' in the project root for more details)
+ * Comments:    
+ *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include "ChainBuffer.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+using namespace FILES;
+
+namespace
+{
+    /// The size of the first allocated segment
+    const size_t MIN_SEGMENT = 4096;
+
+    /// The segments grow up to this size (unless a larger one is needed at once)
+    const size_t MAX_SEGMENT = 1024 * 1024;
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *\
+ *                                                                                       *
+ *     class Block:                                                                      *
+ *                                                                                       *
+\* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+Block::Block(size_t size):
+    myData(static_cast<char *>(malloc(size))),
+    mySize(size)
+{
+ ASSERT(myData || !size, "Memory allocation problem");
+}
+
+Block::~Block()
+{
+ free(myData);
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *\
+ *                                                                                       *
+ *     class ChainBuffer:                                                                *
+ *                                                                                       *
+\* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+ChainBuffer::ChainBuffer(void):
+    myCurrent(0),
+    mySize(0),
+    myAllocated(0)
+{
+ Segment first = { myInline, 0, INLINE_SIZE };
+ mySegments.push_back(first);
+}
+
+ChainBuffer::~ChainBuffer()
+{
+ shrink();
+}
+
+size_t ChainBuffer::Write(const void * d, size_t size)
+{
+ const char * source = static_cast<const char *>(d);
+
+ for (size_t left = size; left; ) {
+    Segment & segment = mySegments[myCurrent];
+    size_t room = segment.capacity - segment.size;
+    if (!room) {
+        NextSegment(left);
+        continue;
+    }
+    if (room > left) {
+        room = left;
+    }
+    memcpy(segment.data + segment.size, source, room);
+    segment.size += room;
+    source += room;
+    left -= room;
+ }
+
+ mySize += size;
+
+ return size;
+}
+
+off_t ChainBuffer::Tell(void) const
+{
+ return mySize;
+}
+
+std::string ChainBuffer::GetFullPath(void) const
+{
+ return "Memory-ChainBuffer";
+}
+
+void ChainBuffer::Write(FILES::Output & out) const
+{
+ if (mySegments[myCurrent].size == mySize) {
+    out.Write(mySegments[myCurrent].data, mySize);
+    return;
+ }
+
+ IoVector vec;
+ AddTo(vec);
+ out.WriteV(vec);
+}
+
+void ChainBuffer::AddTo(IoVector & vec) const
+{
+ for (size_t i = 0; i <= myCurrent; ++i) {
+    vec.Add(mySegments[i].data, mySegments[i].size);
+ }
+}
+
+void ChainBuffer::reserve(size_t size)
+{
+ if (!mySize && size > INLINE_SIZE) {
+    // Use one segment for all the data, in front of the other unused ones:
+    for (size_t i = 1; i < mySegments.size(); ++i) {
+        if (mySegments[i].capacity >= size) {
+            std::swap(mySegments[1], mySegments[i]);
+            myCurrent = 1;
+            return;
+        }
+    }
+    Segment segment = { static_cast<char *>(malloc(size)), 0, size };
+    ASSERT(segment.data, "Memory allocation problem");
+    mySegments.insert(mySegments.begin() + 1, segment);
+    myAllocated += size;
+    myCurrent = 1;
+    return;
+ }
+
+ size_t room = 0;
+ for (size_t i = myCurrent; i < mySegments.size(); ++i) {
+    room += mySegments[i].capacity - mySegments[i].size;
+ }
+
+ if (room < size) {
+    AddSegment(size - room);
+ }
+}
+
+void ChainBuffer::clear(void)
+{
+ for (size_t i = 0; i < mySegments.size(); ++i) {
+    mySegments[i].size = 0;
+ }
+
+ myCurrent = 0;
+ mySize = 0;
+}
+
+void ChainBuffer::shrink(void)
+{
+ for (size_t i = 1; i < mySegments.size(); ++i) {
+    free(mySegments[i].data);
+ }
+
+ mySegments.resize(1);
+ myAllocated = 0;
+
+ clear();
+}
+
+void ChainBuffer::CopyTo(void * dest) const
+{
+ char * target = static_cast<char *>(dest);
+
+ for (size_t i = 0; i <= myCurrent; ++i) {
+    const Segment & segment = mySegments[i];
+    memcpy(target, segment.data, segment.size);
+    target += segment.size;
+ }
+}
+
+Block ChainBuffer::Detach(void)
+{
+ if (!mySize) {
+    return Block();
+ }
+
+ for (size_t i = 1; i <= myCurrent; ++i) {
+    Segment & segment = mySegments[i];
+    if (segment.size == mySize) {
+        // All the data is here, take it out:
+        Block result(segment.data, segment.size);
+        myAllocated -= segment.capacity;
+        mySegments.erase(mySegments.begin() + i);
+        clear();
+        return result;
+    }
+ }
+
+ Block result(mySize);
+ CopyTo(result.get());
+ clear();
+
+ return result;
+}
+
+void ChainBuffer::NextSegment(size_t needed)
+{
+ // After clear(), the segments behind the current one are empty and can be reused:
+ if (myCurrent + 1 < mySegments.size()) {
+    ++myCurrent;
+    return;
+ }
+
+ // Double the total capacity:
+ size_t capacity = myAllocated < MIN_SEGMENT ? MIN_SEGMENT : myAllocated;
+ if (capacity > MAX_SEGMENT) {
+    capacity = MAX_SEGMENT;
+ }
+ if (capacity < needed) {
+    capacity = needed;
+ }
+
+ AddSegment(capacity);
+ ++myCurrent;
+}
+
+void ChainBuffer::AddSegment(size_t capacity)
+{
+ Segment segment = { static_cast<char *>(malloc(capacity)), 0, capacity };
+ ASSERT(segment.data, "Memory allocation problem");
+
+ mySegments.push_back(segment);
+ myAllocated += capacity;
+}
+
+/* * * * * * * * * * * * * End - of - File * * * * * * * * * * * * * * */
@@ -0,0 +1,192 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *
+ * Project:     My Generic C++ Library
+ * Purpose:     Growable memory buffer made of segments
+ * Author:      György Kövesdi (kgy@etiner.hu)
+ * Licence:     GPL (see file 'COPYING' in the project root for more details)
+ * Comments:    The interface is similar to the file handler classes.
+ *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef __SRC_FILE_CHAINBUFFER_H_INCLUDED__
+#define __SRC_FILE_CHAINBUFFER_H_INCLUDED__
+
+#include <File/Base.h>
+#include <File/IoVector.h>
+#include <Memory/Memory.h>
+
+#include <vector>
+#include <string>
+#include <utility>
+#include <stdint.h>
+
+namespace FILES
+{
+    class ChainBuffer;
+
+    /// Contiguous, owned memory block, it can be moved without copying
+    class Block: public FILES::Writeable
+    {
+        friend class ChainBuffer;
+
+     public:
+        inline Block(void):
+            myData(nullptr),
+            mySize(0)
+        {
+        }
+
+        /// Allocates an uninitialized block
+        explicit Block(size_t size);
+
+        inline Block(Block && other):
+            myData(other.myData),
+            mySize(other.mySize)
+        {
+            other.myData = nullptr;
+            other.mySize = 0;
+        }
+
+        inline Block & operator=(Block && other)
+        {
+            std::swap(myData, other.myData);
+            std::swap(mySize, other.mySize);
+            return *this;
+        }
+
+        Block(const Block &) = delete;
+        Block & operator=(const Block &) = delete;
+
+        virtual ~Block();
+
+        virtual const void * GetData(void) const override
+        {
+            return myData;
+        }
+
+        virtual size_t GetSize(void) const override
+        {
+            return mySize;
+        }
+
+        inline char * get(void)
+        {
+            return myData;
+        }
+
+     private:
+        /// Takes the ownership of memory allocated by malloc()
+        inline Block(char * data, size_t size):
+            myData(data),
+            mySize(size)
+        {
+        }
+
+        char * myData;
+
+        size_t mySize;
+
+    }; // class FILES::Block
+
+    /// Growable memory buffer
+    /*! The small contents are stored within the object, the larger ones in a chain of segments, so
+     *  the data already written is never copied. */
+    class ChainBuffer: public FILES::Output, public MEM::noncopyable
+    {
+     public:
+        /// Size of the storage within the object
+        static const size_t INLINE_SIZE = 128;
+
+        /// One part of the data
+        struct Segment
+        {
+            char * data;
+
+            /// Number of bytes used
+            size_t size;
+
+            size_t capacity;
+
+        }; // struct FILES::ChainBuffer::Segment
+
+        ChainBuffer(void);
+        virtual ~ChainBuffer();
+
+        virtual size_t Write(const void * d, size_t size) override;
+        virtual off_t Tell(void) const override;
+        virtual std::string GetFullPath(void) const override;
+
+        /// Writes the contents to the given output by one \ref FILES::Output::WriteV()
+        void Write(FILES::Output & out) const;
+
+        /// Adds the non-empty segments to the vector
+        void AddTo(IoVector & vec) const;
+
+        /// Total number of bytes stored
+        inline size_t GetSize(void) const
+        {
+            return mySize;
+        }
+
+        inline bool empty(void) const
+        {
+            return !mySize;
+        }
+
+        /// Number of segments, including the empty ones
+        inline size_t GetSegmentCount(void) const
+        {
+            return mySegments.size();
+        }
+
+        /// Returns a segment, the first one is the inline storage
+        inline const Segment & GetSegment(size_t index) const
+        {
+            return mySegments[index];
+        }
+
+        /// Makes sure that 'size' more bytes can be written without allocation
+        void reserve(size_t size);
+
+        /// Empties the buffer, the storage is kept
+        void clear(void);
+
+        /// Releases the storage, except the inline one
+        void shrink(void);
+
+        /// Copies the whole contents to 'dest', which must have \ref ChainBuffer::GetSize() bytes
+        void CopyTo(void * dest) const;
+
+        /// Takes out the contents as one block, without copy if it is in one allocated segment
+        Block Detach(void);
+
+     private:
+        SYS_DEFINE_CLASS_NAME("FILES::ChainBuffer");
+
+        /// Switches to the next segment, allocates it if necessary
+        void NextSegment(size_t needed);
+
+        /// Allocates a new segment after the current one
+        void AddSegment(size_t capacity);
+
+        /// The segments, the first one is \ref ChainBuffer::myInline
+        std::vector<Segment> mySegments;
+
+        /// Index of the segment being written
+        size_t myCurrent;
+
+        /// Sum of the sizes of the segments
+        size_t mySize;
+
+        /// Sum of the capacities of the allocated segments
+        size_t myAllocated;
+
+        char myInline[INLINE_SIZE];
+
+    }; // class FILES::ChainBuffer
+
+} // namespace FILES
+
+#endif /* __SRC_FILE_CHAINBUFFER_H_INCLUDED__ */
+
+/* * * * * * * * * * * * * End - of - File * * * * * * * * * * * * * * */
@@ -0,0 +1,153 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *
+ * Project:     My Generic C++ Library
+ * Purpose:     Block-based character search in memory
+ * Author:      György Kövesdi (kgy@etiner.hu)
+ * Licence:     GPL (see file 'COPYING' in the project root for more details)
+ * Comments:    SSE2/AVX2 is used on x86, selected at runtime.
+ *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include "CharScan.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || (defined(__i386__) && defined(__SSE2__)))
+#define CHARSCAN_X86
+#include <immintrin.h>
+#endif
+
+using namespace FILES;
+
+const char CharScan::SPACES[] = " \t\n\v\f\r";
+
+namespace
+{
+    typedef const char * (*ScanFunction)(const char * begin, const char * end, const char * set, size_t set_size, bool negate);
+
+    inline bool InSet(char ch, const char * set, size_t set_size)
+    {
+        for (size_t i = 0; i < set_size; ++i) {
+            if (ch == set[i]) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    const char * ScanScalar(const char * begin, const char * end, const char * set, size_t set_size, bool negate)
+    {
+        if (set_size > CharScan::MAX_VECTOR_SET) {
+            bool table[256] = { false };
+            for (size_t i = 0; i < set_size; ++i) {
+                table[(unsigned char)set[i]] = true;
+            }
+            for (; begin < end && table[(unsigned char)*begin] == negate; ++begin) {
+            }
+            return begin;
+        }
+        for (; begin < end && InSet(*begin, set, set_size) == negate; ++begin) {
+        }
+        return begin;
+    }
+
+#ifdef CHARSCAN_X86
+
+    const char * ScanSse2(const char * begin, const char * end, const char * set, size_t set_size, bool negate)
+    {
+        if (set_size > CharScan::MAX_VECTOR_SET || !set_size) {
+            return ScanScalar(begin, end, set, set_size, negate);
+        }
+
+        __m128i needles[CharScan::MAX_VECTOR_SET];
+        for (size_t i = 0; i < set_size; ++i) {
+            needles[i] = _mm_set1_epi8(set[i]);
+        }
+        const unsigned invert = negate ? 0xffff : 0;
+
+        for (; end - begin >= 16; begin += 16) {
+            __m128i data = _mm_loadu_si128(reinterpret_cast<const __m128i *>(begin));
+            __m128i hit = _mm_cmpeq_epi8(data, needles[0]);
+            for (size_t i = 1; i < set_size; ++i) {
+                hit = _mm_or_si128(hit, _mm_cmpeq_epi8(data, needles[i]));
+            }
+            unsigned mask = _mm_movemask_epi8(hit) ^ invert;
+            if (mask) {
+                return begin + __builtin_ctz(mask);
+            }
+        }
+
+        return ScanScalar(begin, end, set, set_size, negate);
+    }
+
+    __attribute__((target("avx2")))
+    const char * ScanAvx2(const char * begin, const char * end, const char * set, size_t set_size, bool negate)
+    {
+        if (set_size > CharScan::MAX_VECTOR_SET || !set_size) {
+            return ScanScalar(begin, end, set, set_size, negate);
+        }
+
+        __m256i needles[CharScan::MAX_VECTOR_SET];
+        for (size_t i = 0; i < set_size; ++i) {
+            needles[i] = _mm256_set1_epi8(set[i]);
+        }
+        const unsigned invert = negate ? 0xffffffff : 0;
+
+        for (; end - begin >= 32; begin += 32) {
+            __m256i data = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(begin));
+            __m256i hit = _mm256_cmpeq_epi8(data, needles[0]);
+            for (size_t i = 1; i < set_size; ++i) {
+                hit = _mm256_or_si256(hit, _mm256_cmpeq_epi8(data, needles[i]));
+            }
+            unsigned mask = (unsigned)_mm256_movemask_epi8(hit) ^ invert;
+            if (mask) {
+                return begin + __builtin_ctz(mask);
+            }
+        }
+
+        // The tail is processed by 16-byte blocks:
+        return ScanSse2(begin, end, set, set_size, negate);
+    }
+
+    ScanFunction SelectScan(void)
+    {
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("avx2") ? &ScanAvx2 : &ScanSse2;
+    }
+
+#else
+
+    ScanFunction SelectScan(void)
+    {
+        return &ScanScalar;
+    }
+
+#endif /* CHARSCAN_X86 */
+
+    /// Returns the implementation selected for this CPU
+    /*! \note   It is not a global variable, because it can be used by static constructors too. */
+    inline ScanFunction GetScan(void)
+    {
+        static const ScanFunction scan = SelectScan();
+        return scan;
+    }
+}
+
+const char * CharScan::FindFirstOf(const char * begin, const char * end, const char * set, size_t set_size)
+{
+ return GetScan()(begin, end, set, set_size, false);
+}
+
+const char * CharScan::FindFirstNotOf(const char * begin, const char * end, const char * set, size_t set_size)
+{
+ return GetScan()(begin, end, set, set_size, true);
+}
+
+const char * CharScan::GetImplementation(void)
+{
+#ifdef CHARSCAN_X86
+ return GetScan() == &ScanAvx2 ? "avx2" : "sse2";
+#else
+ return "scalar";
+#endif
+}
+
+/* * * * * * * * * * * * * End - of - File * * * * * * * * * * * * * * */
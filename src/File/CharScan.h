@@ -0,0 +1,54 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *
+ * Project:     My Generic C++ Library
+ * Purpose:     Block-based character search in memory
+ * Author:      György Kövesdi (kgy@etiner.hu)
+ * Licence:     GPL (see file 'COPYING' in the project root for more details)
+ * Comments:    SSE2/AVX2 is used on x86, selected at runtime.
+ *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef __SRC_FILE_CHARSCAN_H_INCLUDED__
+#define __SRC_FILE_CHARSCAN_H_INCLUDED__
+
+#include <stddef.h>
+#include <string.h>
+
+namespace FILES
+{
+    /// Character search functions for large memory areas
+    /*! \note   The functions never read outside the [begin, end) area. */
+    namespace CharScan
+    {
+        /// The largest set searched by vector instructions
+        const size_t MAX_VECTOR_SET = 8;
+
+        /// The whitespace characters, as isspace() in the "C" locale
+        extern const char SPACES[];
+
+        /// Finds the first character which is in the set, or returns 'end'
+        const char * FindFirstOf(const char * begin, const char * end, const char * set, size_t set_size);
+
+        /// Finds the first character which is not in the set, or returns 'end'
+        const char * FindFirstNotOf(const char * begin, const char * end, const char * set, size_t set_size);
+
+        inline const char * FindFirstOf(const char * begin, const char * end, const char * set)
+        {
+            return FindFirstOf(begin, end, set, strlen(set));
+        }
+
+        inline const char * FindFirstNotOf(const char * begin, const char * end, const char * set)
+        {
+            return FindFirstNotOf(begin, end, set, strlen(set));
+        }
+
+        /// The name of the implementation selected for this CPU: "avx2", "sse2" or "scalar"
+        const char * GetImplementation(void);
+
+    } // namespace FILES::CharScan
+
+} // namespace FILES
+
+#endif /* __SRC_FILE_CHARSCAN_H_INCLUDED__ */
+
+/* * * * * * * * * * * * * End - of - File * * * * * * * * * * * * * * */
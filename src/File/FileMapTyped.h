@@ -12,18 +12,114 @@
 #define __BASELIB_SRC_FILE_FILEMAPTYPED_H_INCLUDED__
 
 #include <File/FileMap.h>
+#include <File/CharScan.h>
+#include <Memory/Span.h>
+#include <Exceptions/Exceptions.h>
+
+#include <type_traits>
+#include <string.h>
 
 namespace FILES
 {
+    /// Maps a file as an array of the given type
     template <typename T>
     class FileMap_typed: public FileMap
     {
      public:
+        typedef T value_type;
+        typedef T * iterator;
+        typedef const T * const_iterator;
+
         inline FileMap_typed(const char * name, FileMap::OpenMode mode = Read_Only, size_t p_size = 0):
             FileMap(name, mode, p_size * sizeof(T))
         {
         }
 
+        /// Number of complete elements in the file
+        inline size_t size(void) const
+        {
+            return FileMap::GetSize() / sizeof(T);
+        }
+
+        inline bool empty(void) const
+        {
+            return !size();
+        }
+
+        inline T * begin(void)
+        {
+            return reinterpret_cast<T *>(FileMap::GetData());
+        }
+
+        inline T * end(void)
+        {
+            return begin() + size();
+        }
+
+        inline const T * begin(void) const
+        {
+            return reinterpret_cast<const T *>(FileMap::GetData());
+        }
+
+        inline const T * end(void) const
+        {
+            return begin() + size();
+        }
+
+        inline MEM::Span<T> span(void)
+        {
+            return MEM::Span<T>(begin(), size());
+        }
+
+        inline MEM::Span<const T> span(void) const
+        {
+            return MEM::Span<const T>(begin(), size());
+        }
+
+        /// Returns a part of the array
+        inline MEM::Span<T> slice(size_t offset, size_t count = (size_t)-1)
+        {
+            return span().subspan(offset, count);
+        }
+
+        inline MEM::Span<const T> slice(size_t offset, size_t count = (size_t)-1) const
+        {
+            return span().subspan(offset, count);
+        }
+
+        /// Element access with bounds check
+        inline T & at(size_t index)
+        {
+            ASSERT(index < size(), "index " << index << " is out of range (" << size() << " elements)");
+            return begin()[index];
+        }
+
+        inline const T & at(size_t index) const
+        {
+            ASSERT(index < size(), "index " << index << " is out of range (" << size() << " elements)");
+            return begin()[index];
+        }
+
+        /// Reads a value of any type from the given byte offset, which must be aligned for U
+        template <typename U>
+        inline U LoadAligned(size_t byte_offset) const
+        {
+            static_assert(std::is_trivially_copyable<U>::value, "only trivially copyable types can be loaded");
+            ASSERT(byte_offset % alignof(U) == 0 && byte_offset + sizeof(U) <= FileMap::GetSize(), "invalid aligned load at " << byte_offset);
+            return *reinterpret_cast<const U *>(reinterpret_cast<const char *>(FileMap::GetData()) + byte_offset);
+        }
+
+        /// Reads a value of any type from the given byte offset, without alignment requirements
+        template <typename U>
+        inline U LoadUnaligned(size_t byte_offset) const
+        {
+            static_assert(std::is_trivially_copyable<U>::value, "only trivially copyable types can be loaded");
+            ASSERT(byte_offset + sizeof(U) <= FileMap::GetSize(), "invalid load at " << byte_offset);
+            U result;
+            memcpy(&result, reinterpret_cast<const char *>(FileMap::GetData()) + byte_offset, sizeof(U));
+            return result;
+        }
+
         virtual inline ~FileMap_typed()
         {
         }
@@ -66,7 +162,7 @@ namespace FILES
         {
         }
 
-        off_t GetPosition(void) { return (off_t)actual - (off_t)&*this; }
+        off_t GetPosition(void) { return actual - reinterpret_cast<const char *>(mapped); }
 
         int ChrGet(void)
         {
@@ -85,7 +181,69 @@ namespace FILES
                 --actual;
         }
 
+        /// The characters not read yet
+        inline MEM::Span<const char> Remaining(void) const
+        {
+            return MEM::Span<const char>(actual, actual < (char*)ende ? (char*)ende - actual : 0);
+        }
+
+        /// Advances to the next character which is in the set, returns false at the end
+        inline bool SkipTo(const char * set)
+        {
+            return Advance(CharScan::FindFirstOf(actual, End(), set)) < End();
+        }
+
+        /// Skips the whitespace characters, returns them
+        inline MEM::Span<const char> SkipSpace(void)
+        {
+            const char * begin = actual;
+            return MEM::Span<const char>(begin, Advance(CharScan::FindFirstNotOf(actual, End(), CharScan::SPACES)) - begin);
+        }
+
+        /// Reads the characters until the first character in the set, it is not consumed
+        inline MEM::Span<const char> ReadUntil(const char * set)
+        {
+            const char * begin = actual;
+            return MEM::Span<const char>(begin, Advance(CharScan::FindFirstOf(actual, End(), set)) - begin);
+        }
+
+        /// Reads the rest of the line, without the end of line (LF, CR or CR LF)
+        inline MEM::Span<const char> ReadLine(void)
+        {
+            MEM::Span<const char> line = ReadUntil("\r\n");
+            if (actual < (char*)ende && *actual++ == '\r' && actual < (char*)ende && *actual == '\n') {
+                ++actual;
+            }
+            return line;
+        }
+
+        /// Reads the next whitespace-delimited word, it is empty at the end
+        inline MEM::Span<const char> ReadToken(void)
+        {
+            SkipSpace();
+            return ReadUntil(CharScan::SPACES);
+        }
+
      protected:
+        virtual void Remapped(const void * old_address) override
+        {
+            actual = reinterpret_cast<char *>(mapped) + (actual - reinterpret_cast<const char *>(old_address));
+        }
+
+        /// The end of the area to be scanned
+        /*! \note   After EOF, \ref FileMap_char::ChrGet() moves the position beyond the end. */
+        inline const char * End(void) const
+        {
+            return actual < (char*)ende ? (char*)ende : actual;
+        }
+
+        /// Sets the position to the given character
+        inline const char * Advance(const char * position)
+        {
+            actual = const_cast<char *>(position);
+            return position;
+        }
+
         char * actual;
 
      private:
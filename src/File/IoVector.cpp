@@ -0,0 +1,32 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *
+ * Project:     My Generic C++ Library
+ * Purpose:     Gather list for vectored output
+ * Author:      György Kövesdi (kgy@etiner.hu)
+ * Licence:     GPL (see file 'COPYING' in the project root for more details)
+ * Comments:
+ *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include "IoVector.h"
+
+using namespace FILES;
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *\
+ *                                                                                       *
+ *     class Output:                                                                     *
+ *                                                                                       *
+\* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+size_t Output::WriteV(const IoVector & vec)
+{
+ size_t result = 0;
+
+ for (size_t i = 0; i < vec.GetCount(); ++i) {
+    result += Write(vec[i].iov_base, vec[i].iov_len);
+ }
+
+ return result;
+}
+
+/* * * * * * * * * * * * * End - of - File * * * * * * * * * * * * * * */
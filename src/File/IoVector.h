@@ -0,0 +1,111 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *
+ * Project:     My Generic C++ Library
+ * Purpose:     Gather list for vectored output
+ * Author:      György Kövesdi (kgy@etiner.hu)
+ * Licence:     GPL (see file 'COPYING' in the project root for more details)
+ * Comments:
+ *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef __SRC_FILE_IOVECTOR_H_INCLUDED__
+#define __SRC_FILE_IOVECTOR_H_INCLUDED__
+
+#include <File/Base.h>
+
+#include <vector>
+#include <type_traits>
+#include <sys/uio.h>
+
+namespace FILES
+{
+    /// List of memory areas to be written at once by \ref FILES::Output::WriteV()
+    /*! \warning    Only the addresses are stored, the data must be kept until it is written. */
+    class IoVector
+    {
+     public:
+        inline IoVector(void):
+            mySize(0)
+        {
+        }
+
+        /// Adds a memory area, it is merged with the previous one if they are adjacent
+        inline IoVector & Add(const void * data, size_t size)
+        {
+            if (!size) {
+                return *this;
+            }
+            if (!myVector.empty()) {
+                struct iovec & last = myVector.back();
+                if (static_cast<const char *>(last.iov_base) + last.iov_len == data) {
+                    last.iov_len += size;
+                    mySize += size;
+                    return *this;
+                }
+            }
+            struct iovec area;
+            area.iov_base = const_cast<void *>(data);
+            area.iov_len = size;
+            myVector.push_back(area);
+            mySize += size;
+            return *this;
+        }
+
+        inline IoVector & Add(const Writeable & data)
+        {
+            return Add(data.GetData(), data.GetSize());
+        }
+
+        /// Adds a variable by reference
+        template <typename T>
+        inline typename std::enable_if<!std::is_base_of<Writeable, T>::value, IoVector &>::type Add(const T & value)
+        {
+            static_assert(std::is_trivially_copyable<T>::value, "only trivially copyable types can be written directly");
+            return Add(&value, sizeof value);
+        }
+
+        inline void clear(void)
+        {
+            myVector.clear();
+            mySize = 0;
+        }
+
+        inline bool empty(void) const
+        {
+            return myVector.empty();
+        }
+
+        /// Number of memory areas
+        inline size_t GetCount(void) const
+        {
+            return myVector.size();
+        }
+
+        /// Total number of bytes
+        inline size_t GetSize(void) const
+        {
+            return mySize;
+        }
+
+        inline const struct iovec * get(void) const
+        {
+            return myVector.data();
+        }
+
+        inline const struct iovec & operator[](size_t index) const
+        {
+            return myVector[index];
+        }
+
+     private:
+        std::vector<struct iovec> myVector;
+
+        size_t mySize;
+
+    }; // class FILES::IoVector
+
+} // namespace FILES
+
+#endif /* __SRC_FILE_IOVECTOR_H_INCLUDED__ */
+
+/* * * * * * * * * * * * * End - of - File * * * * * * * * * * * * * * */
@@ -0,0 +1,153 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *
+ * Project:     My Generic C++ Library
+ * Purpose:     Monotonic (arena) memory allocator
+ * Author:      György Kövesdi (kgy@etiner.hu)
+ * Licence:     GPL (see file 'COPYING' in the project root for more details)
+ * Comments:
+ *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include "Arena.h"
+
+#include <stdlib.h>
+
+using namespace MEM;
+
+namespace
+{
+    /// The arena of the current \ref MEM::ArenaScope of this thread
+    thread_local Arena * currentArena = nullptr;
+
+    /// Header of the \ref MEM::ArenaObject instances
+    /*! It is as large as the maximum alignment, to keep the objects aligned. */
+    union ObjectHeader
+    {
+        Arena * arena;
+
+        std::max_align_t align;
+    };
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *\
+ *                                                                                       *
+ *     class Arena:                                                                      *
+ *                                                                                       *
+\* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+Arena::Arena(size_t blockSize):
+    myBlockSize(blockSize),
+    myBlocks(nullptr),
+    myCurrent(0),
+    myLimit(0),
+    myUsed(0),
+    myReserved(0)
+{
+}
+
+Arena::~Arena()
+{
+ while (myBlocks) {
+    Block * next = myBlocks->next;
+    free(myBlocks);
+    myBlocks = next;
+ }
+}
+
+void * Arena::AllocateSlow(size_t size, size_t align)
+{
+ size_t needed = sizeof(Block) + size + align;
+ size_t blockSize = needed > myBlockSize ? needed : myBlockSize;
+
+ Block * block = static_cast<Block *>(malloc(blockSize));
+ if (!block) {
+    throw std::bad_alloc();
+ }
+ block->size = blockSize;
+ myReserved += blockSize;
+
+ uintptr_t begin = reinterpret_cast<uintptr_t>(block + 1);
+ uintptr_t end = reinterpret_cast<uintptr_t>(block) + blockSize;
+ uintptr_t start = (begin + align - 1) & ~(uintptr_t)(align - 1);
+
+ if (myBlocks && end - (start + size) < myLimit - myCurrent) {
+    // The current block has more free space, keep it as the current one:
+    block->next = myBlocks->next;
+    myBlocks->next = block;
+ } else {
+    block->next = myBlocks;
+    myBlocks = block;
+    myLimit = end;
+    myCurrent = start + size;
+ }
+
+ myUsed += size;
+
+ return reinterpret_cast<void *>(start);
+}
+
+void Arena::Reset(void)
+{
+ if (!myBlocks) {
+    return;
+ }
+
+ // Keep the oldest one:
+ while (myBlocks->next) {
+    Block * next = myBlocks->next;
+    myReserved -= myBlocks->size;
+    free(myBlocks);
+    myBlocks = next;
+ }
+
+ myCurrent = reinterpret_cast<uintptr_t>(myBlocks + 1);
+ myLimit = reinterpret_cast<uintptr_t>(myBlocks) + myBlocks->size;
+ myUsed = 0;
+}
+
+Arena * Arena::Current(void)
+{
+ return currentArena;
+}
+
+void Arena::SetCurrent(Arena * arena)
+{
+ currentArena = arena;
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *\
+ *                                                                                       *
+ *     class ArenaObject:                                                                *
+ *                                                                                       *
+\* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+void * ArenaObject::operator new(size_t size)
+{
+ Arena * arena = currentArena;
+
+ ObjectHeader * header;
+ if (arena) {
+    header = static_cast<ObjectHeader *>(arena->allocate(sizeof(ObjectHeader) + size));
+ } else {
+    header = static_cast<ObjectHeader *>(::operator new(sizeof(ObjectHeader) + size));
+ }
+ header->arena = arena;
+
+ return header + 1;
+}
+
+void ArenaObject::operator delete(void * ptr)
+{
+ if (!ptr) {
+    return;
+ }
+
+ ObjectHeader * header = static_cast<ObjectHeader *>(ptr) - 1;
+
+ // The arena memory is released together with the arena:
+ if (!header->arena) {
+    ::operator delete(header);
+ }
+}
+
+/* * * * * * * * * * * * * End - of - File * * * * * * * * * * * * * * */
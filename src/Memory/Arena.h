@@ -0,0 +1,216 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *
+ * Project:     My Generic C++ Library
+ * Purpose:     Monotonic (arena) memory allocator
+ * Author:      György Kövesdi (kgy@etiner.hu)
+ * Licence:     GPL (see file 'COPYING' in the project root for more details)
+ * Comments:
+ *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef __SRC_MEMORY_ARENA_H_INCLUDED__
+#define __SRC_MEMORY_ARENA_H_INCLUDED__
+
+#include <Memory/Memory.h>
+
+#include <new>
+#include <cstddef>
+#include <stdint.h>
+#include <type_traits>
+
+namespace MEM
+{
+    /// Monotonic memory allocator
+    /*! The memory is taken from large blocks sequentially, and released only together, by the
+     *  destructor or \ref MEM::Arena::Reset().
+     *  \note   It is not thread-safe. */
+    class Arena: public MEM::noncopyable
+    {
+     public:
+        /*! \param  blockSize   The larger requests get a separate block. */
+        Arena(size_t blockSize = 4096);
+        ~Arena();
+
+        /// Allocates memory from the arena
+        /*! \param  align   It must be a power of 2. */
+        inline void * allocate(size_t size, size_t align = alignof(std::max_align_t))
+        {
+            uintptr_t start = (myCurrent + align - 1) & ~(uintptr_t)(align - 1);
+            if (start + size > myLimit || !myCurrent) {
+                return AllocateSlow(size, align);
+            }
+            myCurrent = start + size;
+            myUsed += size;
+            return reinterpret_cast<void *>(start);
+        }
+
+        /// Releases memory to the arena, only the last allocation can be reused
+        inline void deallocate(void * ptr, size_t size)
+        {
+            uintptr_t p = reinterpret_cast<uintptr_t>(ptr);
+            if (p + size == myCurrent) {
+                myCurrent = p;
+            }
+        }
+
+        /// Releases all the memory, except the first block
+        /*! \warning    The destructors of the objects are not called. */
+        void Reset(void);
+
+        /// Number of bytes allocated from the arena
+        inline size_t GetUsed(void) const
+        {
+            return myUsed;
+        }
+
+        /// Number of bytes allocated from the heap
+        inline size_t GetReserved(void) const
+        {
+            return myReserved;
+        }
+
+        /// Returns the arena selected for the calling thread by \ref MEM::ArenaScope, or nullptr
+        static Arena * Current(void);
+
+     private:
+        friend class ArenaScope;
+
+        struct Block
+        {
+            Block * next;
+
+            size_t size;
+
+        }; // struct MEM::Arena::Block
+
+        void * AllocateSlow(size_t size, size_t align);
+
+        static void SetCurrent(Arena * arena);
+
+        size_t myBlockSize;
+
+        /// The blocks allocated, the current one is the first
+        Block * myBlocks;
+
+        /// Next free byte in the current block
+        uintptr_t myCurrent;
+
+        /// End of the current block
+        uintptr_t myLimit;
+
+        size_t myUsed;
+
+        size_t myReserved;
+
+    }; // class MEM::Arena
+
+    /// Selects an arena for the calling thread while it exists, the scopes can be nested
+    class ArenaScope: public MEM::noncopyable
+    {
+     public:
+        inline ArenaScope(Arena & arena):
+            myPrevious(Arena::Current())
+        {
+            Arena::SetCurrent(&arena);
+        }
+
+        inline ~ArenaScope()
+        {
+            Arena::SetCurrent(myPrevious);
+        }
+
+     private:
+        Arena * myPrevious;
+
+    }; // class MEM::ArenaScope
+
+    /// STL-compatible allocator using a \ref MEM::Arena
+    /*! If it is default-constructed, it takes the arena of the current \ref MEM::ArenaScope, or the heap. */
+    template <typename T>
+    class ArenaAllocator
+    {
+        template <typename U> friend class ArenaAllocator;
+
+     public:
+        typedef T value_type;
+
+        typedef std::true_type propagate_on_container_copy_assignment;
+        typedef std::true_type propagate_on_container_move_assignment;
+        typedef std::true_type propagate_on_container_swap;
+
+        template <typename U>
+        struct rebind
+        {
+            typedef ArenaAllocator<U> other;
+        };
+
+        inline ArenaAllocator(void):
+            myArena(Arena::Current())
+        {
+        }
+
+        inline ArenaAllocator(Arena & arena):
+            myArena(&arena)
+        {
+        }
+
+        template <typename U>
+        inline ArenaAllocator(const ArenaAllocator<U> & other):
+            myArena(other.myArena)
+        {
+        }
+
+        inline T * allocate(size_t n)
+        {
+            if (myArena) {
+                return static_cast<T *>(myArena->allocate(n * sizeof(T), alignof(T)));
+            }
+            return static_cast<T *>(::operator new(n * sizeof(T)));
+        }
+
+        inline void deallocate(T * p, size_t n)
+        {
+            if (myArena) {
+                myArena->deallocate(p, n * sizeof(T));
+            } else {
+                ::operator delete(p);
+            }
+        }
+
+        inline Arena * GetArena(void) const
+        {
+            return myArena;
+        }
+
+        template <typename U>
+        inline bool operator==(const ArenaAllocator<U> & other) const
+        {
+            return myArena == other.myArena;
+        }
+
+        template <typename U>
+        inline bool operator!=(const ArenaAllocator<U> & other) const
+        {
+            return myArena != other.myArena;
+        }
+
+     private:
+        Arena * myArena;
+
+    }; // class MEM::ArenaAllocator
+
+    /// Base class for the classes allocated from the arena of the current \ref MEM::ArenaScope
+    /*! \note   It costs a small header in front of each object. */
+    class ArenaObject
+    {
+     public:
+        static void * operator new(size_t size);
+        static void operator delete(void * ptr);
+
+    }; // class MEM::ArenaObject
+
+} // namespace MEM
+
+#endif /* __SRC_MEMORY_ARENA_H_INCLUDED__ */
+
+/* * * * * * * * * * * * * End - of - File * * * * * * * * * * * * * * */
@@ -14,6 +14,7 @@
 #define __AUTON_H__
 
 #include <string.h>
+#include <atomic>
 
 #include <System/Generic.h>
 #include <Threads/Mutex.h>
@@ -60,7 +61,8 @@ namespace _AutonPrivate
         friend class Auton<I>;
 
      public:
-        AutonInterface(const char * p_name)
+        AutonInterface(const char * p_name):
+            myMutex("AutonInterface")
         {
             if (!myTypeName) {
                 SetName(p_name);
@@ -73,12 +75,16 @@ namespace _AutonPrivate
          */
         virtual ~AutonInterface()
         {
-            delete myInterface;
+            delete myInterface.load(std::memory_order_acquire);
         }
 
         // *** Has already been commented, see below *** //
         bool _ForceImplementation(const char * typeName);
 
+        /// The helper instance of the Interface
+        /*! \note   It is public, because it is used by the macro ::AUTON_FORCE */
+        static AutonInterface<I> myStaticImplementation;
+
      private:
         void SetName(const char * p_name)
         {
@@ -111,30 +117,45 @@ namespace _AutonPrivate
         /// Checks if the Implementation is instantiated or not
         inline bool IsInstantiated(void)
         {
-            return myInterface;
+            return myInterface.load(std::memory_order_acquire);
         }
 
         /// Increments the reference counter
-        /*! \see AutonInterface::references
+        /*! If the Interface is already in use, the counter is incremented without locking. Only
+            the first usage (0 -> 1) takes the mutex, to be serialized with \ref AutonInterface::Drop()
+            deleting the Implementation.
+            \see AutonInterface::references
             \note   It is called by each constructor of the corresponding type
          */
         inline void Use(void)
         {
+            int count = references.load(std::memory_order_relaxed);
+            while (count > 0) {
+                if (references.compare_exchange_weak(count, count + 1, std::memory_order_relaxed)) {
+                    return;
+                }
+            }
             Threads::Lock _l(myMutex);
-            ++references;
+            references.fetch_add(1, std::memory_order_relaxed);
         }
 
         /// Decrements the reference counter
-        /*! Also deletes the Implementation if it was the last usage.
+        /*! Also deletes the Implementation if it was the last usage. Only the last usage (1 -> 0)
+            takes the mutex.
             \see AutonInterface::references
             \note   It is called by each destructor of the corresponding type
          */
         inline void Drop(void)
         {
+            int count = references.load(std::memory_order_relaxed);
+            while (count > 1) {
+                if (references.compare_exchange_weak(count, count - 1, std::memory_order_release, std::memory_order_relaxed)) {
+                    return;
+                }
+            }
             Threads::Lock _l(myMutex);
-            if (--references == 0) {
-                delete myInterface;
-                myInterface = (I*)0;
+            if (references.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                delete myInterface.exchange(nullptr, std::memory_order_acq_rel);
             }
         }
 
@@ -165,14 +186,17 @@ namespace _AutonPrivate
 
         /// This is the current Implementation
         /*! It can be NULL if it has not been instantiated yet, or has already been deleted.
+            \note   It is published with release semantics, so it can be read without locking.
+            \note   It is not initialized by the constructor: the static object is zero-initialized,
+                    and it may have been used before its constructor is called.
          */
-        volatile I * myInterface;
+        std::atomic<I *> myInterface;
 
         /// Reference counter for the Interface
         /*! \see AutonInterface::Drop()
             \see AutonInterface::Use()
          */
-        int references;
+        std::atomic<int> references;
 
         /// The Implementation Name
         /*! \note   It is stored only for debug purposes.
@@ -188,8 +212,6 @@ namespace _AutonPrivate
         /*! It will lock all the operation to guarantee thread-safety for \ref Auton.
          */
         Threads::Mutex myMutex;
-
-        static AutonInterface<I> myStaticImplementation;
     };
 
     /// Generic, Implementation-independent base of class \ref AutonHandler
@@ -477,15 +499,18 @@ namespace _AutonPrivate
     template <class I>
     inline I * AutonInterface<I>::GetImplementation(void)
     {
-        if (myInterface) {
-            return (I*)myInterface; // It is already created, nothing to do
+        I * result = myInterface.load(std::memory_order_acquire);
+        if (result) {
+            return result; // It is already created, nothing to do
         }
         Threads::Lock _l(myMutex);
-        if (myInterface) {
-            return (I*)myInterface; // Somebody else has just created it
+        result = myInterface.load(std::memory_order_relaxed);
+        if (result) {
+            return result; // Somebody else has just created it
         }
-        myInterface = CreateImplementation();
-        return (I*)myInterface;
+        result = CreateImplementation();
+        myInterface.store(result, std::memory_order_release);
+        return result;
     }
 }
 
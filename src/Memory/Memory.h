@@ -12,6 +12,8 @@
 #define __SRC_MEMORY_MEMORY_H_INCLUDED__
 
 #include <memory>
+#include <atomic>
+#include <utility>
 
 namespace MEM
 {
@@ -39,13 +41,23 @@ namespace MEM
         {
         }
 
+        inline shared_ptr(const shared_ptr & other):
+            super(other)
+        {
+        }
+
+        inline shared_ptr(shared_ptr && other):
+            super(std::move(other))
+        {
+        }
+
         inline shared_ptr(const super & other):
             super(other)
         {
         }
 
         inline shared_ptr(super && other):
-            super(other)
+            super(std::move(other))
         {
         }
 
@@ -57,22 +69,194 @@ namespace MEM
 
         template <typename U>
         inline shared_ptr(U && other):
-            super(other)
+            super(std::forward<U>(other))
         {
         }
 
         inline ~shared_ptr()
         {
-            std::atomic_store(this, super());
+            super().swap(*this);
+        }
+
+        inline shared_ptr & operator=(const shared_ptr & other)
+        {
+            super::operator=(other);
+            return *this;
+        }
+
+        inline shared_ptr & operator=(shared_ptr && other)
+        {
+            super::operator=(std::move(other));
+            return *this;
         }
 
+        using super::operator=;
+
         inline void reset(T * ptr = nullptr)
         {
-            std::atomic_store(this, super(ptr));
+            super(ptr).swap(*this);
         }
 
     }; // class MEM::shared_ptr
 
+    /// Base class for objects referenced by \ref MEM::intrusive_ptr
+    /*! \param  Counter Use 'int' if the objects are never shared between threads. */
+    template <class T, typename Counter = std::atomic<int> >
+    class RefCounted
+    {
+     public:
+        inline void reference(void) const
+        {
+            ++reference_counter;
+        }
+
+        /// Decrements the reference counter and deletes the object if it was the last reference
+        inline void unreference(void) const
+        {
+            if (!--reference_counter) {
+                delete static_cast<const T *>(this);
+            }
+        }
+
+     protected:
+        inline RefCounted(void):
+            reference_counter(0)
+        {
+        }
+
+        inline RefCounted(const RefCounted &):
+            reference_counter(0)
+        {
+        }
+
+        inline RefCounted & operator=(const RefCounted &)
+        {
+            return *this;
+        }
+
+        inline ~RefCounted()
+        {
+        }
+
+     private:
+        mutable Counter reference_counter;
+
+    }; // class MEM::RefCounted
+
+    /// Smart pointer to objects having their own reference counter, see \ref MEM::RefCounted
+    template <typename T>
+    class intrusive_ptr
+    {
+        template <typename U> friend class intrusive_ptr;
+
+     public:
+        inline intrusive_ptr(void):
+            myPtr(nullptr)
+        {
+        }
+
+        inline intrusive_ptr(T * ptr):
+            myPtr(ptr)
+        {
+            if (myPtr) {
+                myPtr->reference();
+            }
+        }
+
+        inline intrusive_ptr(const intrusive_ptr & other):
+            intrusive_ptr(other.myPtr)
+        {
+        }
+
+        inline intrusive_ptr(intrusive_ptr && other):
+            myPtr(other.myPtr)
+        {
+            other.myPtr = nullptr;
+        }
+
+        template <typename U>
+        inline intrusive_ptr(const intrusive_ptr<U> & other):
+            intrusive_ptr(other.myPtr)
+        {
+        }
+
+        template <typename U>
+        inline intrusive_ptr(intrusive_ptr<U> && other):
+            myPtr(other.myPtr)
+        {
+            other.myPtr = nullptr;
+        }
+
+        inline ~intrusive_ptr()
+        {
+            T * ptr = myPtr;
+            myPtr = nullptr;
+            if (ptr) {
+                ptr->unreference();
+            }
+        }
+
+        inline intrusive_ptr & operator=(intrusive_ptr other)
+        {
+            swap(other);
+            return *this;
+        }
+
+        inline void reset(T * ptr = nullptr)
+        {
+            intrusive_ptr(ptr).swap(*this);
+        }
+
+        inline void swap(intrusive_ptr & other)
+        {
+            std::swap(myPtr, other.myPtr);
+        }
+
+        inline T * get(void) const
+        {
+            return myPtr;
+        }
+
+        inline T * operator->() const
+        {
+            return myPtr;
+        }
+
+        inline T & operator*() const
+        {
+            return *myPtr;
+        }
+
+        inline explicit operator bool() const
+        {
+            return myPtr;
+        }
+
+        template <typename U>
+        inline bool operator==(const intrusive_ptr<U> & other) const
+        {
+            return myPtr == other.myPtr;
+        }
+
+        template <typename U>
+        inline bool operator!=(const intrusive_ptr<U> & other) const
+        {
+            return myPtr != other.myPtr;
+        }
+
+     private:
+        T * myPtr;
+
+    }; // class MEM::intrusive_ptr
+
+    /// Prints the stored pointer, similarly to std::shared_ptr
+    template <typename T, typename S>
+    inline S & operator<<(S & os, const intrusive_ptr<T> & ptr)
+    {
+        os << ptr.get();
+        return os;
+    }
+
     template <typename T>
     class scoped_ptr: public std::unique_ptr<T>
     {
@@ -0,0 +1,376 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *
+ * Project:     My Generic C++ Library
+ * Purpose:     Fixed-size object pool with per-thread caches
+ * Author:      György Kövesdi (kgy@etiner.hu)
+ * Licence:     GPL (see file 'COPYING' in the project root for more details)
+ * Comments:
+ *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef __SRC_MEMORY_OBJECTPOOL_H_INCLUDED__
+#define __SRC_MEMORY_OBJECTPOOL_H_INCLUDED__
+
+#include <Memory/Memory.h>
+#include <Threads/Mutex.h>
+
+#include <new>
+#include <atomic>
+#include <vector>
+#include <cstddef>
+#include <utility>
+#include <stdint.h>
+#include <type_traits>
+
+namespace MEM
+{
+    /// Pool of memory for objects of type T
+    /*! Each thread has its own free list, refilled from (and returned to) the global one in batches.
+     *  \param  batchSize   The number of elements moved at once.
+     *  \note   The memory is never returned to the heap. */
+    template <typename T, size_t batchSize = 64>
+    class ObjectPool: public MEM::noncopyable
+    {
+        static_assert(alignof(T) <= alignof(std::max_align_t), "over-aligned types are not supported");
+        static_assert(batchSize > 0, "the batch size must be positive");
+
+     public:
+        /// Occupancy and efficiency counters
+        struct Stats
+        {
+            /// Number of elements allocated from the heap
+            size_t capacity;
+
+            /// Number of elements in use
+            size_t inUse;
+
+            /// Number of free elements in the thread caches
+            size_t cached;
+
+            /// Number of free elements in the global free list
+            size_t available;
+
+            /// Number of allocations served from the thread cache
+            uint64_t hits;
+
+            /// Number of allocations needed to refill the thread cache
+            uint64_t misses;
+
+        }; // struct MEM::ObjectPool::Stats
+
+        /// Returns the pool of this type
+        /*! \note   It is never deleted, because the objects can be released during the exit. */
+        static inline ObjectPool & Instance(void)
+        {
+            static ObjectPool * pool = new ObjectPool;
+            return *pool;
+        }
+
+        /// Allocates memory for an object
+        inline void * Allocate(void)
+        {
+            Cache * c = GetCache();
+            if (!c) {
+                return AllocateGlobal();
+            }
+            Cache & cache = *c;
+            Node * node = cache.myFree;
+            if (node) {
+                Increment(cache.myHits);
+            } else {
+                node = Refill(cache);
+            }
+            cache.myFree = node->next;
+            cache.myCount.store(cache.myCount.load(std::memory_order_relaxed) - 1, std::memory_order_relaxed);
+            return node;
+        }
+
+        /// Releases the memory of a destroyed object, from any thread
+        inline void Release(void * ptr)
+        {
+            Node * node = static_cast<Node *>(ptr);
+            Cache * c = GetCache();
+            if (!c) {
+                ReleaseGlobal(node);
+                return;
+            }
+            Cache & cache = *c;
+            node->next = cache.myFree;
+            cache.myFree = node;
+            size_t count = cache.myCount.load(std::memory_order_relaxed) + 1;
+            cache.myCount.store(count, std::memory_order_relaxed);
+            if (count >= 2 * batchSize) {
+                Return(cache, batchSize);
+            }
+        }
+
+        /// Returns the current counters, they are approximate while the pool is used
+        inline Stats GetStats(void)
+        {
+            Threads::Lock _l(myMutex);
+            Stats result;
+            result.capacity = myCapacity;
+            result.available = myAvailable;
+            result.cached = 0;
+            result.hits = myRetiredHits;
+            result.misses = myRetiredMisses;
+            for (typename std::vector<Cache *>::const_iterator i = myCaches.begin(); i != myCaches.end(); ++i) {
+                result.cached += (*i)->myCount.load(std::memory_order_relaxed);
+                result.hits += (*i)->myHits.load(std::memory_order_relaxed);
+                result.misses += (*i)->myMisses.load(std::memory_order_relaxed);
+            }
+            result.inUse = myCapacity - myAvailable - result.cached;
+            return result;
+        }
+
+     private:
+        union Node
+        {
+            Node * next;
+
+            typename std::aligned_storage<sizeof(T), alignof(T)>::type storage;
+        };
+
+        /// A chain of free elements
+        struct Chain
+        {
+            Node * head;
+
+            size_t count;
+        };
+
+        /// The cache of one thread
+        class Cache: public MEM::noncopyable
+        {
+         public:
+            inline Cache(ObjectPool & pool, bool & destroyed):
+                myPool(pool),
+                myDestroyed(destroyed),
+                myFree(nullptr),
+                myCount(0),
+                myHits(0),
+                myMisses(0)
+            {
+                Threads::Lock _l(myPool.myMutex);
+                myPool.myCaches.push_back(this);
+            }
+
+            /// Returns all the elements to the global list at the exit of the thread
+            inline ~Cache()
+            {
+                myDestroyed = true;
+                myPool.Return(*this, myCount.load(std::memory_order_relaxed));
+                Threads::Lock _l(myPool.myMutex);
+                myPool.myRetiredHits += myHits.load(std::memory_order_relaxed);
+                myPool.myRetiredMisses += myMisses.load(std::memory_order_relaxed);
+                for (typename std::vector<Cache *>::iterator i = myPool.myCaches.begin(); i != myPool.myCaches.end(); ++i) {
+                    if (*i == this) {
+                        myPool.myCaches.erase(i);
+                        break;
+                    }
+                }
+            }
+
+            ObjectPool & myPool;
+
+            /// Set when the cache is destroyed, see \ref MEM::ObjectPool::GetCache()
+            bool & myDestroyed;
+
+            Node * myFree;
+
+            std::atomic<size_t> myCount;
+
+            std::atomic<uint64_t> myHits;
+
+            std::atomic<uint64_t> myMisses;
+
+        }; // class MEM::ObjectPool::Cache
+
+        inline ObjectPool(void):
+            myMutex("ObjectPool"),
+            myCapacity(0),
+            myAvailable(0),
+            myRetiredHits(0),
+            myRetiredMisses(0)
+        {
+            myLoose.head = nullptr;
+            myLoose.count = 0;
+        }
+
+        static inline void Increment(std::atomic<uint64_t> & counter)
+        {
+            counter.store(counter.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        }
+
+        /// Returns the cache of the calling thread, or nullptr if it has been destroyed at the exit
+        inline Cache * GetCache(void)
+        {
+            // It has no destructor, so it is still valid after the destructor of the cache:
+            static thread_local bool destroyed = false;
+            if (destroyed) {
+                return nullptr;
+            }
+            static thread_local Cache cache(*this, destroyed);
+            return &cache;
+        }
+
+        /// Allocates one element from the global list, without thread cache
+        Node * AllocateGlobal(void)
+        {
+            Threads::Lock _l(myMutex);
+            if (!myLoose.count) {
+                if (myChains.empty()) {
+                    myLoose = NewChain();
+                    myAvailable += myLoose.count;
+                } else {
+                    myLoose = myChains.back();
+                    myChains.pop_back();
+                }
+            }
+            Node * node = myLoose.head;
+            myLoose.head = node->next;
+            --myLoose.count;
+            --myAvailable;
+            return node;
+        }
+
+        /// Releases one element to the global list, without thread cache
+        void ReleaseGlobal(Node * node)
+        {
+            Threads::Lock _l(myMutex);
+            node->next = myLoose.head;
+            myLoose.head = node;
+            ++myAvailable;
+            if (++myLoose.count >= batchSize) {
+                myChains.push_back(myLoose);
+                myLoose.head = nullptr;
+                myLoose.count = 0;
+            }
+        }
+
+        /// Fills the empty thread cache from the global list or from the heap
+        Node * Refill(Cache & cache)
+        {
+            Increment(cache.myMisses);
+
+            Chain chain;
+            {
+                Threads::Lock _l(myMutex);
+                if (!myChains.empty()) {
+                    chain = myChains.back();
+                    myChains.pop_back();
+                    myAvailable -= chain.count;
+                } else if (myLoose.count) {
+                    chain = myLoose;
+                    myLoose.head = nullptr;
+                    myLoose.count = 0;
+                    myAvailable -= chain.count;
+                } else {
+                    chain = NewChain();
+                }
+            }
+
+            cache.myFree = chain.head;
+            cache.myCount.store(chain.count, std::memory_order_relaxed);
+
+            return chain.head;
+        }
+
+        /// Moves elements from the thread cache to the global list
+        void Return(Cache & cache, size_t count)
+        {
+            if (!count) {
+                return;
+            }
+
+            Chain chain;
+            chain.head = cache.myFree;
+            chain.count = count;
+
+            Node * last = cache.myFree;
+            for (size_t i = 1; i < count; ++i) {
+                last = last->next;
+            }
+            cache.myFree = last->next;
+            last->next = nullptr;
+            cache.myCount.store(cache.myCount.load(std::memory_order_relaxed) - count, std::memory_order_relaxed);
+
+            Threads::Lock _l(myMutex);
+            myChains.push_back(chain);
+            myAvailable += count;
+        }
+
+        /// Allocates a new chain from the heap, in locked state
+        Chain NewChain(void)
+        {
+            Node * nodes = static_cast<Node *>(::operator new(batchSize * sizeof(Node)));
+            for (size_t i = 0; i < batchSize - 1; ++i) {
+                nodes[i].next = &nodes[i + 1];
+            }
+            nodes[batchSize - 1].next = nullptr;
+            myCapacity += batchSize;
+
+            Chain result;
+            result.head = nodes;
+            result.count = batchSize;
+            return result;
+        }
+
+        /// Protects the global list and the registry of the caches
+        Threads::Mutex myMutex;
+
+        /// The global free list
+        std::vector<Chain> myChains;
+
+        /// Elements released without thread cache, they are moved to \ref MEM::ObjectPool::myChains in batches
+        Chain myLoose;
+
+        std::vector<Cache *> myCaches;
+
+        size_t myCapacity;
+
+        /// Number of elements in \ref MEM::ObjectPool::myChains and \ref MEM::ObjectPool::myLoose
+        size_t myAvailable;
+
+        /// Counters of the caches of the threads that have already exited
+        uint64_t myRetiredHits;
+
+        uint64_t myRetiredMisses;
+
+    }; // class MEM::ObjectPool
+
+    /// Deleter of the objects allocated by \ref MEM::make_pooled()
+    template <typename T>
+    struct PoolDeleter
+    {
+        inline void operator()(T * ptr) const
+        {
+            ptr->~T();
+            ObjectPool<T>::Instance().Release(ptr);
+        }
+
+    }; // struct MEM::PoolDeleter
+
+    /// Smart pointer to an object allocated from the \ref MEM::ObjectPool
+    template <typename T>
+    using pooled_ptr = std::unique_ptr<T, PoolDeleter<T> >;
+
+    /// Creates an object in the \ref MEM::ObjectPool of its type
+    template <typename T, typename... Args>
+    inline pooled_ptr<T> make_pooled(Args &&... args)
+    {
+        ObjectPool<T> & pool = ObjectPool<T>::Instance();
+        void * ptr = pool.Allocate();
+        try {
+            return pooled_ptr<T>(new (ptr) T(std::forward<Args>(args)...));
+        } catch (...) {
+            pool.Release(ptr);
+            throw;
+        }
+    }
+
+} // namespace MEM
+
+#endif /* __SRC_MEMORY_OBJECTPOOL_H_INCLUDED__ */
+
+/* * * * * * * * * * * * * End - of - File * * * * * * * * * * * * * * */
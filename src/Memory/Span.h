@@ -0,0 +1,99 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *
+ * Project:     My Generic C++ Library
+ * Purpose:     Non-owning view of a contiguous array
+ * Author:      György Kövesdi (kgy@etiner.hu)
+ * Licence:     GPL (see file 'COPYING' in the project root for more details)
+ * Comments:
+ *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef __SRC_MEMORY_SPAN_H_INCLUDED__
+#define __SRC_MEMORY_SPAN_H_INCLUDED__
+
+#include <Exceptions/Exceptions.h>
+
+#include <stddef.h>
+
+namespace MEM
+{
+    /// Pointer and size of an array, without ownership
+    /*! It is similar to std::span of C++20. */
+    template <typename T>
+    class Span
+    {
+     public:
+        typedef T value_type;
+        typedef T * iterator;
+
+        inline Span(void):
+            myData(nullptr),
+            mySize(0)
+        {
+        }
+
+        inline Span(T * data, size_t size):
+            myData(data),
+            mySize(size)
+        {
+        }
+
+        /// Conversion from non-const to const
+        template <typename U>
+        inline Span(const Span<U> & other):
+            myData(other.data()),
+            mySize(other.size())
+        {
+        }
+
+        inline T * data(void) const
+        {
+            return myData;
+        }
+
+        inline size_t size(void) const
+        {
+            return mySize;
+        }
+
+        inline bool empty(void) const
+        {
+            return !mySize;
+        }
+
+        inline T * begin(void) const
+        {
+            return myData;
+        }
+
+        inline T * end(void) const
+        {
+            return myData + mySize;
+        }
+
+        inline T & operator[](size_t index) const
+        {
+            return myData[index];
+        }
+
+        /// Returns a part of the array
+        /*! \param  offset  The first element of the part.
+         *  \param  count   The number of elements, it is limited to the end of the array. */
+        inline Span subspan(size_t offset, size_t count = (size_t)-1) const
+        {
+            ASSERT(offset <= mySize, "subspan at " << offset << " of " << mySize << " elements");
+            return Span(myData + offset, count < mySize - offset ? count : mySize - offset);
+        }
+
+     private:
+        T * myData;
+
+        size_t mySize;
+
+    }; // class MEM::Span
+
+} // namespace MEM
+
+#endif /* __SRC_MEMORY_SPAN_H_INCLUDED__ */
+
+/* * * * * * * * * * * * * End - of - File * * * * * * * * * * * * * * */
@@ -12,10 +12,12 @@
 #define __SRC_THREADS_DATAPIPE_H_INCLUDED__
 
 #include <list>
+#include <utility>
 
 #include <Threads/Error.h>
 #include <Threads/Condition.h>
 #include <Threads/Mutex.h>
+#include <Threads/Deadline.h>
 
 namespace Threads
 {
@@ -25,7 +27,8 @@ namespace Threads
      public:
         inline DataPipe(void):
             currentSize(0),
-            isFinished(false)
+            isFinished(false),
+            myDataMutex("DataPipe")
         {
         }
 
@@ -33,49 +36,92 @@ namespace Threads
 
         inline void push(const DataType & p_data)
         {
-            Threads::Lock _l(myDataMutex);
-            while (currentSize >= maxSize) {
-                myFreeCondition.Wait(myDataMutex);
-                if (isFinished) {
-                    return;
-                }
-            }
-            myData.push_back(p_data);
-            ++currentSize;
-            myUseCondition.Signal();
+            PushInternal(p_data);
+        }
+
+        inline void push(DataType && p_data)
+        {
+            PushInternal(std::move(p_data));
         }
 
         inline void push_drop(const DataType & p_data)
         {
-            if (isFinished) {
-                return;
-            }
+            PushDropInternal(p_data);
+        }
+
+        inline void push_drop(DataType && p_data)
+        {
+            PushDropInternal(std::move(p_data));
+        }
+
+        /// Pushes the element, waits at most until the given time if the pipe is full
+        /*! \retval false   The element is not stored: the deadline has been reached, or
+         *                  \ref DataPipe::finish() has been called. */
+        inline bool push_until(const DataType & p_data, const Threads::Deadline & deadline)
+        {
+            return PushInternal(p_data, &deadline);
+        }
+
+        inline bool push_until(DataType && p_data, const Threads::Deadline & deadline)
+        {
+            return PushInternal(std::move(p_data), &deadline);
+        }
+
+        /// Pushes the element, waits at most for the given time if the pipe is full
+        /*! \see DataPipe::push_until() */
+        template <class Rep, class Period>
+        inline bool push_for(const DataType & p_data, const std::chrono::duration<Rep, Period> & timeout)
+        {
+            return push_until(p_data, Threads::DeadlineAfter(timeout));
+        }
+
+        template <class Rep, class Period>
+        inline bool push_for(DataType && p_data, const std::chrono::duration<Rep, Period> & timeout)
+        {
+            return push_until(std::move(p_data), Threads::DeadlineAfter(timeout));
+        }
+
+        /// Pushes a range of elements, in as few critical sections as possible
+        /*! \retval The number of elements stored, it is less only after \ref DataPipe::finish(). */
+        template <typename InputIterator>
+        inline size_t push_many(InputIterator first, InputIterator last)
+        {
+            size_t stored = 0;
             Threads::Lock _l(myDataMutex);
-            while (currentSize >= maxSize) {
-                myData.pop_front();
-                --currentSize;
+            while (first != last) {
+                while (currentSize >= maxSize) {
+                    if (isFinished) {
+                        return stored;
+                    }
+                    if (stored) {
+                        myUseCondition.Broadcast();
+                    }
+                    myFreeCondition.Wait(myDataMutex);
+                }
+                size_t batch = 0;
+                for ( ; first != last && currentSize < maxSize; ++first, ++batch) {
+                    myData.push_back(*first);
+                    ++currentSize;
+                }
+                stored += batch;
+                if (first == last) {
+                    if (batch > 1) {
+                        myUseCondition.Broadcast();
+                    } else {
+                        myUseCondition.Signal();
+                    }
+                }
             }
-            myData.push_back(p_data);
-            ++currentSize;
-            myUseCondition.Signal();
+            return stored;
         }
 
         inline DataType pop(void)
         {
             Threads::Lock _l(myDataMutex);
-            while (true) {
-                if (!myData.empty()) {
-                    DataType result = myData.front();
-                    myData.pop_front();
-                    --currentSize;
-                    myFreeCondition.Signal();
-                    return result;
-                }
-                if (isFinished) {
-                    return DataType();
-                }
-                myUseCondition.Wait(myDataMutex);
+            if (!WaitForData(nullptr)) {
+                return DataType();
             }
+            return PopLocked();
         }
 
         inline DataType pop_nowait(void)
@@ -84,11 +130,57 @@ namespace Threads
             if (myData.empty()) {
                 return DataType();
             }
-            DataType result = myData.front();
-            myData.pop_front();
-            --currentSize;
-            myFreeCondition.Signal();
-            return result;
+            return PopLocked();
+        }
+
+        /// Gets the oldest element, waits at most until the given time
+        /*! \retval false   Nothing is got: the deadline has been reached, or the pipe is empty and
+         *                  \ref DataPipe::finish() has been called. */
+        inline bool pop_until(DataType & p_data, const Threads::Deadline & deadline)
+        {
+            Threads::Lock _l(myDataMutex);
+            if (!WaitForData(&deadline)) {
+                return false;
+            }
+            p_data = PopLocked();
+            return true;
+        }
+
+        /// Gets the oldest element, waits at most for the given time
+        /*! \see DataPipe::pop_until() */
+        template <class Rep, class Period>
+        inline bool pop_for(DataType & p_data, const std::chrono::duration<Rep, Period> & timeout)
+        {
+            return pop_until(p_data, Threads::DeadlineAfter(timeout));
+        }
+
+        /// Moves the available elements (at most 'max') to 'out', waits for the first one
+        /*! \param  milliseconds    Zero means not to wait, negative value means to wait forever.
+         *  \retval The number of elements got, zero after timeout or finish. */
+        template <typename OutputIterator>
+        inline size_t pop_many(OutputIterator out, size_t max, int milliseconds = -1)
+        {
+            Threads::Deadline deadline;
+            if (milliseconds >= 0) {
+                deadline = Threads::DeadlineAfterMilliseconds(milliseconds);
+            }
+            Threads::Lock _l(myDataMutex);
+            if (!WaitForData(milliseconds < 0 ? nullptr : &deadline)) {
+                return 0;
+            }
+            size_t got = 0;
+            for ( ; got < max && !myData.empty(); ++got) {
+                *out = std::move(myData.front());
+                ++out;
+                myData.pop_front();
+                --currentSize;
+            }
+            if (got > 1) {
+                myFreeCondition.Broadcast();
+            } else {
+                myFreeCondition.Signal();
+            }
+            return got;
         }
 
         inline bool busy(void) const
@@ -101,15 +193,88 @@ namespace Threads
             return currentSize;
         }
 
+        /// Finishes the pipe
+        /*! All the threads blocked in push or pop operations are released. */
         inline void finish(void)
         {
             Threads::Lock _l(myDataMutex);
             isFinished = true;
+            myUseCondition.Broadcast();
+            myFreeCondition.Broadcast();
+        }
+
+     protected:
+        /// Stores one element
+        /*! \param  deadline    If it is not nullptr, it does not wait beyond it, and fails after finish. */
+        template <typename U>
+        inline bool PushInternal(U && p_data, const Threads::Deadline * deadline = nullptr)
+        {
+            Threads::Lock _l(myDataMutex);
+            if (deadline && isFinished) {
+                return false;
+            }
+            while (currentSize >= maxSize) {
+                if (deadline) {
+                    if (!myFreeCondition.WaitUntil(myDataMutex, *deadline) && currentSize >= maxSize) {
+                        return false;
+                    }
+                } else {
+                    myFreeCondition.Wait(myDataMutex);
+                }
+                if (isFinished) {
+                    return false;
+                }
+            }
+            myData.push_back(std::forward<U>(p_data));
+            ++currentSize;
             myUseCondition.Signal();
+            return true;
+        }
+
+        /// Waits until an element is available, returns false after timeout or finish
+        /*! \warning    It must be called in locked state. */
+        inline bool WaitForData(const Threads::Deadline * deadline)
+        {
+            while (myData.empty()) {
+                if (isFinished) {
+                    return false;
+                }
+                if (!deadline) {
+                    myUseCondition.Wait(myDataMutex);
+                } else if (Threads::Clock::now() >= *deadline || !myUseCondition.WaitUntil(myDataMutex, *deadline)) {
+                    return !myData.empty();
+                }
+            }
+            return true;
+        }
+
+        /// Removes and returns the oldest element
+        /*! \warning    It must be called in locked state, and the pipe must not be empty. */
+        inline DataType PopLocked(void)
+        {
+            DataType result = std::move(myData.front());
+            myData.pop_front();
+            --currentSize;
             myFreeCondition.Signal();
+            return result;
+        }
+
+        template <typename U>
+        inline void PushDropInternal(U && p_data)
+        {
+            if (isFinished) {
+                return;
+            }
+            Threads::Lock _l(myDataMutex);
+            while (currentSize >= maxSize) {
+                myData.pop_front();
+                --currentSize;
+            }
+            myData.push_back(std::forward<U>(p_data));
+            ++currentSize;
+            myUseCondition.Signal();
         }
 
-     protected:
         size_t currentSize;
 
         bool isFinished;
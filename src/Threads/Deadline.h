@@ -0,0 +1,78 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *
+ * Project:     My Generic C++ Library
+ * Purpose:     Time limit for the blocking thread operations
+ * Author:      György Kövesdi (kgy@etiner.hu)
+ * Licence:     GPL (see file 'COPYING' in the project root for more details)
+ * Comments:    
+ *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef __SRC_THREADS_DEADLINE_H_INCLUDED__
+#define __SRC_THREADS_DEADLINE_H_INCLUDED__
+
+#include <chrono>
+#include <time.h>
+#include <stdint.h>
+
+namespace Threads
+{
+    /// The clock used by the timed waits
+    /*! It is not affected by setting the system time. */
+    typedef std::chrono::steady_clock Clock;
+
+    /// Absolute time limit of a blocking operation
+    typedef Clock::time_point Deadline;
+
+    template <class Rep, class Period>
+    inline Deadline DeadlineAfter(const std::chrono::duration<Rep, Period> & timeout)
+    {
+        return Clock::now() + std::chrono::duration_cast<Clock::duration>(timeout);
+    }
+
+    inline Deadline DeadlineAfterMilliseconds(uint32_t milliseconds)
+    {
+        return DeadlineAfter(std::chrono::milliseconds(milliseconds));
+    }
+
+    /// Converts the deadline to an absolute time of the given clock
+    /*! \note   It does not assume anything about the epoch of \ref Threads::Clock: only the remaining
+     *          time is converted. */
+    inline struct timespec ToClock(const Deadline & deadline, clockid_t clock)
+    {
+        Clock::duration left = deadline - Clock::now();
+        if (left < Clock::duration::zero()) {
+            left = Clock::duration::zero();
+        }
+        long long ns = std::chrono::duration_cast<std::chrono::nanoseconds>(left).count();
+        struct timespec ts;
+        clock_gettime(clock, &ts);
+        ts.tv_sec += ns / 1000000000LL;
+        ts.tv_nsec += ns % 1000000000LL;
+        if (ts.tv_nsec >= 1000000000L) {
+            ts.tv_nsec -= 1000000000L;
+            ts.tv_sec += 1;
+        }
+        return ts;
+    }
+
+    /// Converts the deadline to an absolute CLOCK_MONOTONIC time
+    /*! This is the format expected by the pthread and futex system calls. */
+    inline struct timespec ToMonotonic(const Deadline & deadline)
+    {
+        return ToClock(deadline, CLOCK_MONOTONIC);
+    }
+
+    /// Converts the deadline to an absolute CLOCK_REALTIME time
+    /*! This is the format expected by the older calls, like sem_timedwait().
+     *  \warning    If the system time is set, the result becomes wrong. */
+    inline struct timespec ToRealtime(const Deadline & deadline)
+    {
+        return ToClock(deadline, CLOCK_REALTIME);
+    }
+
+} // namespace Threads
+
+#endif /* __SRC_THREADS_DEADLINE_H_INCLUDED__ */
+
+/* * * * * * * * * * * * * End - of - File * * * * * * * * * * * * * * */
@@ -0,0 +1,116 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *
+ * Project:     My Generic C++ Library
+ * Purpose:     Parallel algorithms on arrays
+ * Author:      György Kövesdi (kgy@etiner.hu)
+ * Licence:     GPL (see file 'COPYING' in the project root for more details)
+ * Comments:
+ *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef __SRC_THREADS_PARALLELSCAN_H_INCLUDED__
+#define __SRC_THREADS_PARALLELSCAN_H_INCLUDED__
+
+#include <Threads/ThreadPool.h>
+#include <Memory/Span.h>
+
+#include <vector>
+#include <atomic>
+
+namespace Threads
+{
+    /// Helpers to split an array into chunks for \ref Threads::ThreadPool::parallel_for()
+    /*! The chunks are large enough to make the per-chunk overhead negligible, and the inner loops
+     *  are simple loops over contiguous elements, so the compiler can vectorize them. */
+    namespace ParallelScan
+    {
+        /// The size of one chunk in bytes
+        const size_t CHUNK_BYTES = 256 * 1024;
+
+        template <typename T>
+        inline size_t ChunkSize(void)
+        {
+            return sizeof(T) < CHUNK_BYTES ? CHUNK_BYTES / sizeof(T) : 1;
+        }
+
+        template <typename T>
+        inline size_t ChunkCount(const MEM::Span<T> & data)
+        {
+            return (data.size() + ChunkSize<T>() - 1) / ChunkSize<T>();
+        }
+
+        /// The index after the last element of the given chunk
+        template <typename T>
+        inline size_t ChunkEnd(const MEM::Span<T> & data, size_t index)
+        {
+            size_t end = (index + 1) * ChunkSize<T>();
+            return end < data.size() ? end : data.size();
+        }
+
+    } // namespace Threads::ParallelScan
+
+    /// Calls the function for each element, on the workers of the pool
+    /*! \param  func    Called as func(T & element). The order of the calls is not defined. */
+    template <typename T, class F>
+    void for_each(ThreadPool & pool, const MEM::Span<T> & data, F && func)
+    {
+        const size_t chunk = ParallelScan::ChunkSize<T>();
+        pool.parallel_for(0, ParallelScan::ChunkCount(data), [&](size_t index) {
+            T * end = data.data() + ParallelScan::ChunkEnd(data, index);
+            for (T * p = data.data() + index * chunk; p < end; ++p) {
+                func(*p);
+            }
+        }, 1);
+    }
+
+    /// Calculates a value from all the elements, on the workers of the pool
+    /*! \param  init    The identity element of 'combine', e.g. 0 for a sum.
+     *  \param  combine Combines two partial results, it must be associative. */
+    template <typename T, typename R, class Op, class Combine>
+    R reduce(ThreadPool & pool, const MEM::Span<T> & data, R init, Op && op, Combine && combine)
+    {
+        const size_t chunk = ParallelScan::ChunkSize<T>();
+        std::vector<R> partial(ParallelScan::ChunkCount(data), init);
+        pool.parallel_for(0, partial.size(), [&](size_t index) {
+            T * end = data.data() + ParallelScan::ChunkEnd(data, index);
+            R value = init;
+            for (T * p = data.data() + index * chunk; p < end; ++p) {
+                value = op(value, *p);
+            }
+            partial[index] = value;
+        }, 1);
+        R result = init;
+        for (size_t i = 0; i < partial.size(); ++i) {
+            result = combine(result, partial[i]);
+        }
+        return result;
+    }
+
+    /// Finds the first element matching the predicate, returns data.size() if there is none
+    template <typename T, class P>
+    size_t find_if(ThreadPool & pool, const MEM::Span<T> & data, P && pred)
+    {
+        const size_t chunk = ParallelScan::ChunkSize<T>();
+        std::atomic<size_t> found(data.size());
+        pool.parallel_for(0, ParallelScan::ChunkCount(data), [&](size_t index) {
+            size_t end = ParallelScan::ChunkEnd(data, index);
+            for (size_t i = index * chunk; i < end; ++i) {
+                if ((i & 1023) == 0 && i >= found.load(std::memory_order_relaxed)) {
+                    return;
+                }
+                if (pred(data[i])) {
+                    size_t current = found.load(std::memory_order_relaxed);
+                    while (i < current && !found.compare_exchange_weak(current, i, std::memory_order_relaxed)) {
+                    }
+                    return;
+                }
+            }
+        }, 1);
+        return found.load();
+    }
+
+} // namespace Threads
+
+#endif /* __SRC_THREADS_PARALLELSCAN_H_INCLUDED__ */
+
+/* * * * * * * * * * * * * End - of - File * * * * * * * * * * * * * * */
@@ -0,0 +1,349 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *
+ * Project:     My Generic C++ Library
+ * Purpose:     Lock-free, fixed-size Data Pipe (pass data between threads)
+ * Author:      György Kövesdi (kgy@etiner.hu)
+ * Licence:     GPL (see file 'COPYING' in the project root for more details)
+ * Comments:    The interface is the same as Threads::DataPipe
+ *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef __SRC_THREADS_RINGPIPE_H_INCLUDED__
+#define __SRC_THREADS_RINGPIPE_H_INCLUDED__
+
+#include <Threads/Error.h>
+#include <Threads/Futex.h>
+#include <Threads/Deadline.h>
+#include <System/Generic.h>
+#include <Memory/Memory.h>
+
+#include <atomic>
+#include <new>
+#include <utility>
+#include <stdint.h>
+#include <type_traits>
+
+namespace Threads
+{
+    enum RingMode {
+        /// Single producer, single consumer
+        /*! The producer side does not need any read-modify-write operation. */
+        Ring_SPSC,
+
+        /// Any number of producers and consumers
+        Ring_MPMC
+    };
+
+    /// Fixed-size, lock-free ring buffer to pass data between threads
+    /*! It behaves like \ref Threads::DataPipe, but the elements are stored inline, and the kernel is
+     *  entered only if the caller has to be blocked.
+     *  \param  T           It must be default-constructible, see \ref RingPipe::pop().
+     *  \param  maxSize     The capacity of the pipe, at least 2. */
+    template <typename T, size_t maxSize = 2, RingMode mode = Ring_MPMC>
+    class RingPipe: public MEM::noncopyable
+    {
+        static_assert(maxSize > 1, "RingPipe needs at least two slots");   // A single slot cannot tell full from free
+
+     public:
+        typedef T DataType;
+
+        inline RingPipe(void):
+            myTail(0),
+            myHead(0),
+            isFinished(false)
+        {
+            for (size_t i = 0; i < maxSize; ++i) {
+                mySlots[i].sequence.store(i, std::memory_order_relaxed);
+            }
+        }
+
+        inline ~RingPipe()
+        {
+            while (Dequeue(nullptr)) {
+            }
+        }
+
+        inline void push(const DataType & p_data)
+        {
+            PushBlocking(p_data);
+        }
+
+        inline void push(DataType && p_data)
+        {
+            PushBlocking(std::move(p_data));
+        }
+
+        inline void push_drop(const DataType & p_data)
+        {
+            PushDrop(p_data);
+        }
+
+        inline void push_drop(DataType && p_data)
+        {
+            PushDrop(std::move(p_data));
+        }
+
+        /// Pushes the element, waits at most until the given time if the pipe is full
+        /*! \retval false   The element is not stored: the deadline has been reached, or
+         *                  \ref RingPipe::finish() has been called. */
+        inline bool push_until(const DataType & p_data, const Threads::Deadline & deadline)
+        {
+            return PushBlocking(p_data, &deadline);
+        }
+
+        inline bool push_until(DataType && p_data, const Threads::Deadline & deadline)
+        {
+            return PushBlocking(std::move(p_data), &deadline);
+        }
+
+        template <class Rep, class Period>
+        inline bool push_for(const DataType & p_data, const std::chrono::duration<Rep, Period> & timeout)
+        {
+            return push_until(p_data, Threads::DeadlineAfter(timeout));
+        }
+
+        template <class Rep, class Period>
+        inline bool push_for(DataType && p_data, const std::chrono::duration<Rep, Period> & timeout)
+        {
+            return push_until(std::move(p_data), Threads::DeadlineAfter(timeout));
+        }
+
+        /// Stores the element if there is free space, otherwise it is untouched
+        inline bool try_push(const DataType & p_data)
+        {
+            return Enqueue(p_data);
+        }
+
+        inline bool try_push(DataType && p_data)
+        {
+            return Enqueue(std::move(p_data));
+        }
+
+        /// Moves the oldest element to 'p_data', returns false if the pipe is empty
+        inline bool try_pop(DataType & p_data)
+        {
+            return Dequeue(&p_data);
+        }
+
+        /// Gets the oldest element, waits if necessary, returns T() after finish
+        inline DataType pop(void)
+        {
+            DataType result = DataType();
+            PopBlocking(result, nullptr);
+            return result;
+        }
+
+        /// Gets the oldest element, waits at most until the given time
+        /*! \retval false   Nothing is got: the deadline has been reached, or the pipe is empty and
+         *                  \ref RingPipe::finish() has been called. */
+        inline bool pop_until(DataType & p_data, const Threads::Deadline & deadline)
+        {
+            return PopBlocking(p_data, &deadline);
+        }
+
+        template <class Rep, class Period>
+        inline bool pop_for(DataType & p_data, const std::chrono::duration<Rep, Period> & timeout)
+        {
+            return pop_until(p_data, Threads::DeadlineAfter(timeout));
+        }
+
+        inline DataType pop_nowait(void)
+        {
+            DataType result = DataType();
+            Dequeue(&result);
+            return result;
+        }
+
+        inline bool busy(void) const
+        {
+            return size() > 0;
+        }
+
+        /// Returns the number of elements
+        /*! \note   This is only a snapshot, the value can be changed by other threads at any time. */
+        inline size_t size(void) const
+        {
+            size_t head = myHead.load(std::memory_order_acquire);
+            size_t tail = myTail.load(std::memory_order_acquire);
+            size_t result = tail - head;
+            return result > maxSize ? maxSize : result;
+        }
+
+        inline void finish(void)
+        {
+            isFinished.store(true, std::memory_order_release);
+            myUseEvent.NotifyAll();
+            myFreeEvent.NotifyAll();
+        }
+
+     protected:
+        struct Slot
+        {
+            inline DataType * Get(void)
+            {
+                return reinterpret_cast<DataType *>(&data);
+            }
+
+            std::atomic<size_t> sequence;
+
+            typename std::aligned_storage<sizeof(DataType), alignof(DataType)>::type data;
+
+        }; // struct RingPipe::Slot
+
+        /// Stores one element, waits while the pipe is full
+        /*! \param  deadline    If it is not nullptr, it does not wait beyond it.
+         *  \retval false       The element has not been stored. */
+        template <typename U>
+        inline bool PushBlocking(U && p_data, const Threads::Deadline * deadline = nullptr)
+        {
+            if (deadline && isFinished.load(std::memory_order_acquire)) {
+                return false;
+            }
+            while (!Enqueue(std::forward<U>(p_data))) {
+                if (isFinished.load(std::memory_order_acquire)) {
+                    return false;
+                }
+                int key = myFreeEvent.PrepareWait();
+                if (isFinished.load(std::memory_order_acquire)) {
+                    myFreeEvent.CancelWait();
+                    return false;
+                }
+                if (Enqueue(std::forward<U>(p_data))) {
+                    myFreeEvent.CancelWait();
+                    return true;
+                }
+                if (!deadline) {
+                    myFreeEvent.Wait(key);
+                } else if (!myFreeEvent.WaitUntil(key, *deadline)) {
+                    return Enqueue(std::forward<U>(p_data));
+                }
+            }
+            return true;
+        }
+
+        /// Gets the oldest element, waits while the pipe is empty
+        /*! \param  deadline    If it is not nullptr, it does not wait beyond it.
+         *  \retval false       Nothing is got. */
+        inline bool PopBlocking(DataType & p_data, const Threads::Deadline * deadline)
+        {
+            while (!Dequeue(&p_data)) {
+                if (isFinished.load(std::memory_order_acquire)) {
+                    return false;
+                }
+                int key = myUseEvent.PrepareWait();
+                if (Dequeue(&p_data)) {
+                    myUseEvent.CancelWait();
+                    return true;
+                }
+                if (isFinished.load(std::memory_order_acquire)) {
+                    myUseEvent.CancelWait();
+                    return false;
+                }
+                if (!deadline) {
+                    myUseEvent.Wait(key);
+                } else if (!myUseEvent.WaitUntil(key, *deadline)) {
+                    return Dequeue(&p_data);
+                }
+            }
+            return true;
+        }
+
+        template <typename U>
+        inline void PushDrop(U && p_data)
+        {
+            if (isFinished.load(std::memory_order_acquire)) {
+                return;
+            }
+            while (!Enqueue(std::forward<U>(p_data))) {
+                Dequeue(nullptr);
+            }
+        }
+
+        /// Stores one element
+        /*! \note   The parameter is forwarded only on success, it is untouched if the pipe is full. */
+        template <typename U>
+        inline bool Enqueue(U && p_data)
+        {
+            size_t pos = myTail.load(std::memory_order_relaxed);
+            Slot * slot;
+            for (;;) {
+                slot = &mySlots[pos % maxSize];
+                size_t seq = slot->sequence.load(std::memory_order_acquire);
+                intptr_t diff = (intptr_t)seq - (intptr_t)pos;
+                if (diff == 0) {
+                    if (mode == Ring_SPSC) {
+                        myTail.store(pos + 1, std::memory_order_relaxed);
+                        break;
+                    }
+                    if (myTail.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                        break;
+                    }
+                } else if (diff < 0) {
+                    return false;   // Full
+                } else {
+                    pos = myTail.load(std::memory_order_relaxed);
+                }
+            }
+            new (slot->Get()) DataType(std::forward<U>(p_data));
+            slot->sequence.store(pos + 1, std::memory_order_release);
+            myUseEvent.Notify();
+            return true;
+        }
+
+        /// Removes the oldest element
+        /*! \param  p_data  The element is moved here. If it is nullptr, the element is just dropped. */
+        inline bool Dequeue(DataType * p_data)
+        {
+            size_t pos = myHead.load(std::memory_order_relaxed);
+            Slot * slot;
+            for (;;) {
+                slot = &mySlots[pos % maxSize];
+                size_t seq = slot->sequence.load(std::memory_order_acquire);
+                intptr_t diff = (intptr_t)seq - (intptr_t)(pos + 1);
+                if (diff == 0) {
+                    if (myHead.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                        break;
+                    }
+                } else if (diff < 0) {
+                    return false;   // Empty
+                } else {
+                    pos = myHead.load(std::memory_order_relaxed);
+                }
+            }
+            DataType * data = slot->Get();
+            if (p_data) {
+                *p_data = std::move(*data);
+            }
+            data->~DataType();
+            slot->sequence.store(pos + maxSize, std::memory_order_release);
+            myFreeEvent.Notify();
+            return true;
+        }
+
+        /// Position of the next element to be written
+        std::atomic<size_t> myTail;
+
+        char myPadding1[CACHE_LINE_SIZE - sizeof(std::atomic<size_t>)];
+
+        /// Position of the next element to be read
+        std::atomic<size_t> myHead;
+
+        char myPadding2[CACHE_LINE_SIZE - sizeof(std::atomic<size_t>)];
+
+        std::atomic<bool> isFinished;
+
+        /// Signalled when an element is stored
+        EventCount myUseEvent;
+
+        /// Signalled when an element is removed
+        EventCount myFreeEvent;
+
+        Slot mySlots[maxSize];
+
+    }; // class Threads::RingPipe
+
+} // namespace Threads
+
+#endif /* __SRC_THREADS_RINGPIPE_H_INCLUDED__ */
+
+/* * * * * * * * * * * * * End - of - File * * * * * * * * * * * * * * */
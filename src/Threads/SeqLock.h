@@ -0,0 +1,172 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *
+ * Project:     My Generic C++ Library
+ * Purpose:     Sequence lock for small, frequently read data
+ * Author:      György Kövesdi (kgy@etiner.hu)
+ * Licence:     GPL (see file 'COPYING' in the project root for more details)
+ * Comments:
+ *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef __SRC_THREADS_SEQLOCK_H_INCLUDED__
+#define __SRC_THREADS_SEQLOCK_H_INCLUDED__
+
+#include <Threads/Error.h>
+#include <System/Generic.h>
+#include <Memory/Memory.h>
+
+#include <atomic>
+#include <stdint.h>
+#include <string.h>
+#include <type_traits>
+
+namespace Threads
+{
+    template <typename T>
+    class SeqWriteLock;
+
+    /// Sequence lock for small, rarely written values
+    /*! The readers do not write the shared memory, they retry if a writer has changed the value
+     *  meanwhile. The value is stored in atomic words, so it is not a data race.
+     *  \param  T   A small, trivially copyable type. */
+    template <typename T>
+    class SeqLock: public MEM::noncopyable
+    {
+        static_assert(std::is_trivially_copyable<T>::value, "SeqLock needs trivially copyable data");
+
+        friend class SeqWriteLock<T>;
+
+        typedef uintptr_t Word;
+
+        enum {
+            WORDS = (sizeof(T) + sizeof(Word) - 1) / sizeof(Word)
+        };
+
+     public:
+        inline SeqLock(const T & value = T()):
+            mySequence(0)
+        {
+            Put(value);
+        }
+
+        /// Returns a consistent copy of the value
+        inline T Load(void) const
+        {
+            for (;;) {
+                unsigned seq = mySequence.load(std::memory_order_acquire);
+                if (seq & 1) {
+                    // A writer is working
+                    CPU_RELAX();
+                    continue;
+                }
+                T result = Get();
+                std::atomic_thread_fence(std::memory_order_acquire);
+                if (mySequence.load(std::memory_order_relaxed) == seq) {
+                    return result;
+                }
+            }
+        }
+
+        /// Replaces the value
+        inline void Store(const T & value)
+        {
+            unsigned seq = BeginWrite();
+            Put(value);
+            EndWrite(seq);
+        }
+
+     private:
+        /// Waits for the other writers, then makes the sequence odd
+        inline unsigned BeginWrite(void)
+        {
+            unsigned seq = mySequence.load(std::memory_order_relaxed);
+            for (;;) {
+                if (seq & 1) {
+                    CPU_RELAX();
+                    seq = mySequence.load(std::memory_order_relaxed);
+                    continue;
+                }
+                if (mySequence.compare_exchange_weak(seq, seq + 1, std::memory_order_acquire, std::memory_order_relaxed)) {
+                    break;
+                }
+            }
+            // The readers must see the odd sequence before any modified data:
+            std::atomic_thread_fence(std::memory_order_release);
+            return seq + 1;
+        }
+
+        inline void EndWrite(unsigned seq)
+        {
+            mySequence.store(seq + 1, std::memory_order_release);
+        }
+
+        inline T Get(void) const
+        {
+            Word words[WORDS];
+            for (size_t i = 0; i < WORDS; ++i) {
+                words[i] = myData[i].load(std::memory_order_relaxed);
+            }
+            T result;
+            memcpy(&result, words, sizeof(T));
+            return result;
+        }
+
+        inline void Put(const T & value)
+        {
+            Word words[WORDS] = { 0 };
+            memcpy(words, &value, sizeof(T));
+            for (size_t i = 0; i < WORDS; ++i) {
+                myData[i].store(words[i], std::memory_order_relaxed);
+            }
+        }
+
+        /// Sequence counter, it is odd while a writer is working
+        std::atomic<unsigned> mySequence;
+
+        std::atomic<Word> myData[WORDS];
+
+    }; // class Threads::SeqLock
+
+    /// Modifies the value of a \ref Threads::SeqLock, the destructor stores it back
+    /*! \note   The readers are retrying while it exists. */
+    template <typename T>
+    class SeqWriteLock: public MEM::noncopyable
+    {
+     public:
+        inline SeqWriteLock(SeqLock<T> & lock):
+            myLock(lock),
+            mySequence(lock.BeginWrite()),
+            myValue(lock.Get())
+        {
+        }
+
+        inline ~SeqWriteLock()
+        {
+            myLock.Put(myValue);
+            myLock.EndWrite(mySequence);
+        }
+
+        inline T & operator*(void)
+        {
+            return myValue;
+        }
+
+        inline T * operator->(void)
+        {
+            return &myValue;
+        }
+
+     private:
+        SeqLock<T> & myLock;
+
+        unsigned mySequence;
+
+        T myValue;
+
+    }; // class Threads::SeqWriteLock
+
+} // namespace Threads
+
+#endif /* __SRC_THREADS_SEQLOCK_H_INCLUDED__ */
+
+/* * * * * * * * * * * * * End - of - File * * * * * * * * * * * * * * */
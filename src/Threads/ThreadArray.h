@@ -13,9 +13,16 @@
 
 #include <Threads/Threads.h>
 #include <Threads/Mutex.h>
+#include <Threads/Condition.h>
+#include <Threads/DataPipe.h>
 #include <Memory/Memory.h>
 
-#include <map>
+#include <vector>
+#include <atomic>
+#include <iterator>
+#include <memory>
+#include <functional>
+#include <unordered_map>
 #include <boost/intrusive/list.hpp>
 
 SYS_DECLARE_MODULE(DM_THREAD_ARRAY);
@@ -23,14 +30,18 @@ SYS_DECLARE_MODULE(DM_THREAD_ARRAY);
 namespace Threads
 {
     /// Runs a job on many threads
-    /*! Doc: TODO
-     *  \param      T       This is the identifier of the threads. Can be e.g. int or string.
-     *  \param      U       The parameter passed to each thread. */
-    template <typename T, class U>
+    /*! Each index has its own thread, the least recently used idle one is re-used if the limit is
+     *  reached. The indices are distributed between shards, each with its own lock and LRU list.
+     *  \param      T           This is the identifier of the threads. Can be e.g. int or string.
+     *  \param      U           The parameter passed to each thread.
+     *  \param      mailboxSize The capacity of the mailbox of each job, see \ref ThreadArray::Post(). */
+    template <typename T, class U, size_t mailboxSize = 64, class Hash = std::hash<T> >
     class ThreadArray
     {
         typedef boost::intrusive::list_base_hook<boost::intrusive::link_mode<boost::intrusive::auto_unlink> > auto_unlink_hook;
 
+        struct Shard;
+
      public:
         class Job;
         friend class Job;
@@ -47,9 +58,12 @@ namespace Threads
         inline void Finish(void)
         {
             SYS_DEBUG_MEMBER(DM_THREAD_ARRAY);
-            for (auto i = myThreads.begin(); i != myThreads.end(); ++i) {
-                SYS_DEBUG(DL_INFO2, "Stopping thread " << i->first);
-                i->second->Kill();
+            for (unsigned s = 0; s < no_of_shards; ++s) {
+                ThreadsType & threads = myShards[s].threads;
+                for (auto i = threads.begin(); i != threads.end(); ++i) {
+                    SYS_DEBUG(DL_INFO2, "Stopping thread " << i->first);
+                    i->second->Kill();
+                }
             }
         }
 
@@ -67,6 +81,37 @@ namespace Threads
             /// The main function of the job
             virtual void Work(U task) =0;
 
+            /// Processes the tasks found in the mailbox, by calling \ref ThreadArray::Job::Work() for each
+            virtual void WorkBatch(std::vector<U> & batch)
+            {
+                for (auto i = batch.begin(); i != batch.end(); ++i) {
+                    Work(std::move(*i));
+                }
+            }
+
+            /// Stores a task into the mailbox, blocks while it is full
+            /*! \note   Use \ref ThreadArray::Post(), this job can be re-used for another index meanwhile. */
+            inline void Post(U task)
+            {
+                myPending.fetch_add(1, std::memory_order_acq_rel);
+                myMailbox.push(std::move(task));
+            }
+
+            /// Returns true if there is no posted task to be executed
+            inline bool IsIdle(void) const
+            {
+                return myPending.load(std::memory_order_acquire) == 0;
+            }
+
+            /// Waits until all the posted tasks have been executed
+            void WaitIdle(void)
+            {
+                Threads::Lock _l(myIdleMutex);
+                while (!IsIdle()) {
+                    myIdleCondition.Wait(myIdleMutex);
+                }
+            }
+
             inline const T & GetIndex(void) const
             {
                 return myIndex;
@@ -80,22 +125,39 @@ namespace Threads
             /// Move this job to the top
             void Advance(void) const
             {
-                GetParent().Advance(*this);
+                GetParent().Advance(const_cast<Job &>(*this));
             }
 
          protected:
             inline Job(ThreadArray & parent, const char * thread_name):
                 Threads::Thread(thread_name),
-                myParent(parent)
+                myParent(parent),
+                myShard(nullptr),
+                myPending(0)
             {
                 SYS_DEBUG_MEMBER(DM_THREAD_ARRAY);
-                GetParent().Created(*this);
+            }
+
+            /// Processes the mailbox until the job is stopped
+            /*! The tasks posted before stopping are still executed. */
+            virtual int main(void) override
+            {
+                SYS_DEBUG_MEMBER(DM_THREAD_ARRAY);
+                std::vector<U> batch;
+                batch.reserve(mailboxSize);
+                while (myMailbox.pop_many(std::back_inserter(batch), mailboxSize)) {
+                    WorkBatch(batch);
+                    Done(batch.size());
+                    batch.clear();
+                }
+                return 0;
             }
 
             /// Signals the Thread Server not to use this thread any more and stops the thread
             virtual void KillSignal(void) override
             {
                 GetParent().Deleted(*this);
+                myMailbox.finish();
             }
 
          private:
@@ -103,8 +165,43 @@ namespace Threads
 
             ThreadArray & myParent;
 
+            /// The shard this job belongs to
+            /*! It is set when the job is created, and never changes: a job is re-used within its own shard only. */
+            Shard * myShard;
+
             T myIndex;
 
+            /// The posted tasks
+            Threads::DataPipe<U, mailboxSize> myMailbox;
+
+            /// Number of tasks posted, but not executed yet
+            /*! It is incremented in locked state (see \ref ThreadArray::Reserve()), before the task is posted,
+             *  so a job having pending tasks is never re-used for another index. */
+            std::atomic<size_t> myPending;
+
+            Threads::Mutex myIdleMutex;
+
+            /// Signalled when \ref ThreadArray::Job::myPending becomes zero
+            Threads::Condition myIdleCondition;
+
+            /// Stores a task counted as pending by \ref ThreadArray::Get()
+            inline void PostReserved(U task)
+            {
+                myMailbox.push(std::move(task));
+            }
+
+            /// Called when some tasks have been executed
+            inline void Done(size_t count)
+            {
+                if (myPending.fetch_sub(count, std::memory_order_acq_rel) == count) {
+                    {
+                        Threads::Lock _l(myIdleMutex);
+                        myIdleCondition.Broadcast();
+                    }
+                    GetParent().Released();
+                }
+            }
+
             /// Sets new index
             inline void Reindex(const T & new_index)
             {
@@ -118,128 +215,298 @@ namespace Threads
                 \note           The function \ref ThreadArray::Job::Reindex() will be called after this function, so
                                 the index has the old value (or uninitialized) during this function.
                 \note           It is also called just after the constructor.
-                \warning        We must also wait for finish here to prevent creating more threads for the same target. */
-            virtual void Initialize(const T & index)
+                \note           It is called in locked state, and only for idle jobs: a busy job is never re-used,
+                                see \ref ThreadArray::Get(). */
+            virtual void Initialize(const T & /*index*/)
             {
             }
 
         }; // class ThreadArray::Job
 
         /// Gets the job at the given index
-        JobPtr operator[](const T & index)
+        /*! Only the shard of the given index is locked. */
+        inline JobPtr operator[](const T & index)
+        {
+            return Get(index, false);
+        }
+
+        /// Passes a task to the job at the given index
+        /*! The tasks posted to the same index are executed in order, see \ref ThreadArray::Job::WorkBatch().
+         *  \note   It blocks while the mailbox of that job is full, but it does not block the other indices. */
+        inline void Post(const T & index, U task)
+        {
+            Get(index, true)->PostReserved(std::move(task));
+        }
+
+     protected:
+        /// Gets the job at the given index
+        /*! It waits only if all the jobs of the array are busy, without holding any lock.
+         *  \param  reserve     Count a task as pending, so the job is not re-used before the task is posted. */
+        JobPtr Get(const T & index, bool reserve)
         {
             SYS_DEBUG_MEMBER(DM_THREAD_ARRAY);
-            JobPtr jp;
-            {
-                Threads::Lock _l(myThreadMutex);
-                ThreadPtr & th = myThreads[index];
-                if (th) {
-                    jp = th->self<Job>();
-                    SYS_DEBUG(DL_INFO2, "Using existing " << index << " [" << no_of_threads << " threads]");
-                    jp->unlink();
-                } else {
-                    if (no_of_threads < max_no_of_threads) {
-                        // Create a new thread:
-                        SYS_DEBUG(DL_INFO2, "Creating new thread for " << index << " [" << no_of_threads << " threads]");
-                        jp = CreateJob();
-                        Threads::Thread::Start(jp, myStack);
-                    } else {
-                        // Get the oldest index:
-                        const T & idx = static_cast<Job &>(task_order.back()).GetIndex();
-                        SYS_DEBUG(DL_INFO2, "Re-using '" << idx << "' for '" << index << "' [" << no_of_threads << "]");
-                        // Remove and re-use the oldest existing thread:
-                        jp = RemoveLocked(idx);
+            Shard & shard = GetShard(index);
+            for (;;) {
+                uint64_t released = myReleased.load();
+                {
+                    Threads::Lock _l(shard.mutex);
+                    JobPtr jp = GetLocked(shard, index);
+                    if (jp) {
+                        shard.task_order.push_front(*jp);
+                        if (reserve) {
+                            jp->myPending.fetch_add(1, std::memory_order_acq_rel);
+                        }
+                        return jp;
                     }
-                    // Store it back:
-                    th = jp;
-                    jp->Initialize(index);
-                    jp->Reindex(index);
                 }
-                task_order.push_front(*jp);
+                if (StopIdle(shard)) {
+                    continue;
+                }
+                SYS_DEBUG(DL_INFO2, "All threads are busy for '" << index << "', waiting");
+                WaitReleased(released);
             }
-            return jp;
         }
 
-     protected:
-        ThreadArray(uint32_t max_threads, size_t stack = 1024*1024):
+        /*! \param  max_threads     The maximum number of threads in all the shards together. */
+        ThreadArray(uint32_t max_threads, size_t stack = 1024*1024, unsigned shards = 16):
             myStack(stack),
+            no_of_shards(shards),
             no_of_threads(0),
-            max_no_of_threads(max_threads)
+            max_no_of_threads(max_threads),
+            myReleased(0),
+            myWaiters(0),
+            myReleaseMutex("ThreadArray::Release")
         {
             SYS_DEBUG_MEMBER(DM_THREAD_ARRAY);
+            ASSERT(no_of_shards > 0 && max_no_of_threads > 0, "ThreadArray must be able to hold at least one thread");
+            myShards.reset(new Shard[no_of_shards]);
         }
 
         inline size_t Size(void) const
         {
-            Threads::Lock _l(myThreadMutex);
-            return myThreads.size();
+            size_t result = 0;
+            for (unsigned s = 0; s < no_of_shards; ++s) {
+                Threads::Lock _l(myShards[s].mutex);
+                result += myShards[s].threads.size();
+            }
+            return result;
         }
 
-        typedef std::map<T, ThreadPtr> ThreadsType;
+        typedef std::unordered_map<T, ThreadPtr, Hash> ThreadsType;
 
         inline void Advance(Job & job)
         {
-            Threads::Lock _l(myThreadMutex);
+            Threads::Lock _l(job.myShard->mutex);
             job.unlink();
-            task_order.push_front(job);
+            job.myShard->task_order.push_front(job);
         }
 
-        /// Locks the access to \ref ThreadArray::myThreads and \ref ThreadArray::task_order
-        mutable Threads::Mutex myThreadMutex;
-
-        ThreadsType myThreads;
-
         typedef boost::intrusive::list<Job, boost::intrusive::constant_time_size<false> > TaskList;
 
-        /*! \warning    Its destructor uses \ref myThreadMutex, so the mutex must be defined earlier. */
-        TaskList task_order;
-
      private:
         SYS_DEFINE_CLASS_NAME("Threads/ThreadArray");
 
+        /// One part of the index
+        struct Shard
+        {
+            inline Shard(void):
+                mutex("ThreadArray")
+            {
+            }
+
+            /// Locks the access to \ref Shard::threads and \ref Shard::task_order
+            mutable Threads::Mutex mutex;
+
+            ThreadsType threads;
+
+            /*! \warning    Its destructor uses \ref Shard::mutex, so the mutex must be defined earlier. */
+            TaskList task_order;
+
+        }; // struct ThreadArray::Shard
+
+        /// Finds, creates or re-uses the job for the index
+        /*! \returns    The job, or nullptr if the thread limit is reached and all the jobs of the shard are busy.
+         *  \warning    It must be called in locked state! */
+        JobPtr GetLocked(Shard & shard, const T & index)
+        {
+            SYS_DEBUG_MEMBER(DM_THREAD_ARRAY);
+            JobPtr jp;
+            auto i = shard.threads.find(index);
+            if (i != shard.threads.end()) {
+                ThreadPtr & th = i->second;
+                jp = th->self<Job>();
+                SYS_DEBUG(DL_INFO2, "Using existing " << index << " [" << no_of_threads << " threads]");
+                jp->unlink();
+                return jp;
+            }
+            if (ReserveThread()) {
+                // Create a new thread:
+                SYS_DEBUG(DL_INFO2, "Creating new thread for " << index << " [" << no_of_threads << " threads]");
+                jp = CreateJob();
+                jp->myShard = &shard;
+                Threads::Thread::Start(jp, myStack);
+            } else {
+                Job * oldest = FindIdle(shard);
+                if (!oldest) {
+                    return jp;
+                }
+                const T & idx = oldest->GetIndex();
+                SYS_DEBUG(DL_INFO2, "Re-using '" << idx << "' for '" << index << "' [" << no_of_threads << "]");
+                // Remove and re-use the oldest idle thread:
+                jp = RemoveLocked(shard, idx);
+            }
+            // Store it back:
+            shard.threads[index] = jp;
+            jp->Initialize(index);
+            jp->Reindex(index);
+            return jp;
+        }
+
+        /// Returns the least recently used idle job, or nullptr if all of them are busy
+        /*! \warning    It must be called in locked state! */
+        inline Job * FindIdle(Shard & shard)
+        {
+            for (auto i = shard.task_order.rbegin(); i != shard.task_order.rend(); ++i) {
+                if (i->IsIdle()) {
+                    return &*i;
+                }
+            }
+            return nullptr;
+        }
+
+        /// Counts a new thread if the limit is not reached yet
+        inline bool ReserveThread(void)
+        {
+            uint32_t count = no_of_threads.load(std::memory_order_relaxed);
+            while (count < max_no_of_threads) {
+                if (no_of_threads.compare_exchange_weak(count, count + 1, std::memory_order_relaxed)) {
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        /// Stops the least recently used idle job of another shard, returns false if all are busy
+        bool StopIdle(Shard & except)
+        {
+            SYS_DEBUG_MEMBER(DM_THREAD_ARRAY);
+            for (unsigned s = 0; s < no_of_shards; ++s) {
+                Shard & shard = myShards[s];
+                if (&shard == &except) {
+                    continue;
+                }
+                JobPtr jp;
+                {
+                    Threads::Lock _l(shard.mutex);
+                    Job * oldest = FindIdle(shard);
+                    if (!oldest) {
+                        continue;
+                    }
+                    SYS_DEBUG(DL_INFO2, "Stopping idle '" << oldest->GetIndex() << "' to make room");
+                    jp = RemoveLocked(shard, oldest->GetIndex());
+                    --no_of_threads;
+                }
+                jp->Kill();
+                return true;
+            }
+            return false;
+        }
+
+        /// Called when a job becomes idle, or a thread is deleted
+        inline void Released(void)
+        {
+            myReleased.fetch_add(1);
+            if (myWaiters.load()) {
+                Threads::Lock _l(myReleaseMutex);
+                myReleaseCondition.Broadcast();
+            }
+        }
+
+        /// Waits for \ref ThreadArray::Released()
+        /*! \param  released    The value of \ref ThreadArray::myReleased before the last try. */
+        void WaitReleased(uint64_t released)
+        {
+            ++myWaiters;
+            {
+                Threads::Lock _l(myReleaseMutex);
+                while (myReleased.load() == released) {
+                    myReleaseCondition.Wait(myReleaseMutex);
+                }
+            }
+            --myWaiters;
+        }
+
+        inline Shard & GetShard(const T & index) const
+        {
+            return myShards[myHash(index) % no_of_shards];
+        }
+
         /// Size of the stack for threads
         size_t myStack;
 
-        uint32_t no_of_threads;
+        unsigned no_of_shards;
+
+        /// Number of the jobs in all the shards
+        std::atomic<uint32_t> no_of_threads;
 
         uint32_t max_no_of_threads;
 
+        /// Incremented by \ref ThreadArray::Released()
+        std::atomic<uint64_t> myReleased;
+
+        /// Number of threads in \ref ThreadArray::WaitReleased()
+        std::atomic<int> myWaiters;
+
+        Threads::Mutex myReleaseMutex;
+
+        /*! \warning    The jobs can use it while the shards are destroyed, so it must be defined earlier. */
+        Threads::Condition myReleaseCondition;
+
+        std::unique_ptr<Shard[]> myShards;
+
+        Hash myHash;
+
         /// This virtual function creates a new thread
         virtual JobPtr CreateJob(void) =0;
 
         /// Removes and returns the requested entry
         /*! \warning    It must be called in locked state! (see the caller function(s) for details) */
-        JobPtr RemoveLocked(const T & index)
+        JobPtr RemoveLocked(Shard & shard, const T & index)
         {
             SYS_DEBUG_MEMBER(DM_THREAD_ARRAY);
-            auto i = myThreads.find(index);
-            ASSERT (i != myThreads.end(), "cannot remove thread index '" << index << "' from thread list, it is missing");
+            auto i = shard.threads.find(index);
+            ASSERT (i != shard.threads.end(), "cannot remove thread index '" << index << "' from thread list, it is missing");
             ThreadPtr & p = i->second;
             JobPtr retval = p->self<Job>();
-            myThreads.erase(i); // Invalidates 'i'
+            shard.threads.erase(i); // Invalidates 'i'
             retval->unlink();
             return retval;      // The smart pointer holds the old thread yet
         }
 
-        /*! \warning    The constructor Job::Job() is called in locked state (from function \ref ThreadArray::CreateJob()) */
-        void Created(Job & job)
-        {
-            SYS_DEBUG_MEMBER(DM_THREAD_ARRAY);
-            ++no_of_threads;
-        }
-
         /*! \warning    It is called from the destructor, in non-locked state. */
         void Deleted(const Job & job)
         {
             SYS_DEBUG_MEMBER(DM_THREAD_ARRAY);
-            Threads::Lock _l(myThreadMutex);
-            if (job.is_linked()) {
-                --no_of_threads;
-            }
-            // However, the container's destructor calls unlink(), it must be
-            // called here to prevent unwanted re-use of the deleted class and
-            // other possible race conditions
-            const_cast<Job&>(job).unlink();
+            Shard * shard = job.myShard;
+            if (!shard) {
+                // It has never been used
+                return;
+            }
+            bool counted;
+            {
+                Threads::Lock _l(shard->mutex);
+                counted = job.is_linked();
+                if (counted) {
+                    --no_of_threads;
+                }
+                // However, the container's destructor calls unlink(), it must be
+                // called here to prevent unwanted re-use of the deleted class and
+                // other possible race conditions
+                const_cast<Job&>(job).unlink();
+            }
+            if (counted) {
+                Released();
+            }
         }
 
     }; // class ThreadArray
@@ -0,0 +1,259 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *
+ * Project:     My Generic C++ Library
+ * Purpose:     Work-stealing thread pool
+ * Author:      György Kövesdi (kgy@etiner.hu)
+ * Licence:     GPL (see file 'COPYING' in the project root for more details)
+ * Comments:
+ *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include "ThreadPool.h"
+
+#include <System/SysInfo.h>
+
+SYS_DEFINE_MODULE(DM_THREAD_POOL);
+
+using namespace Threads;
+
+namespace
+{
+    /// The worker running on the current thread, if any
+    thread_local void * currentWorker = nullptr;
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *\
+ *                                                                                       *
+ *     class ThreadPool:                                                                 *
+ *                                                                                       *
+\* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+ThreadPool::ThreadPool(unsigned workers, size_t stack):
+    myInjectedSize(0),
+    isFinished(false)
+{
+ SYS_DEBUG_MEMBER(DM_THREAD_POOL);
+
+ if (!workers) {
+    workers = SYS::CpuInfo::getOnlineCount();
+ }
+
+ SYS_DEBUG(DL_INFO1, "Starting " << workers << " workers");
+
+ // All the workers must exist before any of them starts stealing:
+ for (unsigned i = 0; i < workers; ++i) {
+    myWorkers.push_back(WorkerPtr(new Worker(*this, i)));
+ }
+ for (unsigned i = 0; i < workers; ++i) {
+    Threads::Thread::Start(myWorkers[i], stack);
+ }
+}
+
+ThreadPool::~ThreadPool()
+{
+ SYS_DEBUG_MEMBER(DM_THREAD_POOL);
+
+ Finish();
+}
+
+void ThreadPool::Finish(void)
+{
+ SYS_DEBUG_MEMBER(DM_THREAD_POOL);
+
+ {
+    // Schedule() checks it in locked state, so no task can be injected after the final loop below:
+    Threads::Lock _l(myInjectMutex);
+    if (isFinished.exchange(true)) {
+        return;
+    }
+ }
+
+ myIdleEvent.NotifyAll();
+
+ for (auto i = myWorkers.begin(); i != myWorkers.end(); ++i) {
+    (*i)->Kill();
+ }
+
+ // Tasks submitted after the workers have exited are executed here:
+ while (Task * task = FindTask(nullptr)) {
+    Execute(task);
+ }
+
+ SYS_DEBUG(DL_INFO1, "Workers have been stopped.");
+}
+
+void ThreadPool::Schedule(Task * task)
+{
+ Worker * self = CurrentWorker();
+
+ if (self) {
+    self->myTasks.Push(task);
+ } else {
+    bool finished;
+    {
+        Threads::Lock _l(myInjectMutex);
+        finished = isFinished.load(std::memory_order_acquire);
+        if (!finished) {
+            myInjected.push_back(task);
+            myInjectedSize.fetch_add(1, std::memory_order_release);
+        }
+    }
+    if (finished) {
+        // Nobody would execute it:
+        Execute(task);
+        return;
+    }
+ }
+
+ myIdleEvent.Notify();
+}
+
+ThreadPool::Task * ThreadPool::FindTask(Worker * self)
+{
+ Task * task;
+
+ // The own queue first, it is the most likely in the cache:
+ if (self && self->myTasks.Pop(task)) {
+    return task;
+ }
+
+ if (myInjectedSize.load(std::memory_order_acquire)) {
+    Threads::Lock _l(myInjectMutex);
+    if (!myInjected.empty()) {
+        task = myInjected.front();
+        myInjected.pop_front();
+        myInjectedSize.fetch_sub(1, std::memory_order_relaxed);
+        return task;
+    }
+ }
+
+ // Try to steal, starting from the next one to spread the load:
+ unsigned size = myWorkers.size();
+ unsigned start = self ? self->myIndex + 1 : 0;
+ for (unsigned i = 0; i < size; ++i) {
+    Worker & victim = *myWorkers[(start + i) % size];
+    if (&victim != self && victim.myTasks.Steal(task)) {
+        return task;
+    }
+ }
+
+ return nullptr;
+}
+
+void ThreadPool::Execute(Task * task)
+{
+ try {
+    task->Run();
+ } catch (std::exception & ex) {
+    // Note: submit() and parallel_for() catch their own exceptions, this is unexpected here
+    DEBUG_OUT("Thread Pool: task error: " << ex.what());
+ } catch (...) {
+    DEBUG_OUT("Thread Pool: task error (unknown exception)");
+ }
+ delete task;
+}
+
+ThreadPool::Worker * ThreadPool::CurrentWorker(void) const
+{
+ Worker * self = static_cast<Worker *>(currentWorker);
+
+ if (self && &self->myPool == this) {
+    return self;
+ }
+
+ return nullptr;
+}
+
+void ThreadPool::WaitFor(ParallelBase & job)
+{
+ Worker * self = CurrentWorker();
+
+ for (;;) {
+    int pending = job.Pending().Load();
+    if (!pending) {
+        break;
+    }
+    // Help the others while waiting: the helper tasks of this job may be queued yet
+    Task * task = FindTask(self);
+    if (task) {
+        Execute(task);
+        continue;
+    }
+    // All the helpers are running on other threads:
+    job.Pending().Wait(pending);
+ }
+}
+
+void ThreadPool::WorkerMain(Worker & self)
+{
+ SYS_DEBUG_MEMBER(DM_THREAD_POOL);
+
+ currentWorker = &self;
+
+ for (;;) {
+    Task * task = FindTask(&self);
+    if (task) {
+        Execute(task);
+        continue;
+    }
+    int key = myIdleEvent.PrepareWait();
+    task = FindTask(&self);
+    if (task) {
+        myIdleEvent.CancelWait();
+        Execute(task);
+        continue;
+    }
+    if (isFinished.load(std::memory_order_acquire)) {
+        myIdleEvent.CancelWait();
+        break;
+    }
+    myIdleEvent.Wait(key);
+ }
+
+ currentWorker = nullptr;
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *\
+ *                                                                                       *
+ *     class ThreadPool::ParallelBase:                                                   *
+ *                                                                                       *
+\* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+void ThreadPool::ParallelBase::Run(void)
+{
+ for (;;) {
+    size_t begin = myNext.fetch_add(myGrain, std::memory_order_relaxed);
+    if (begin >= myEnd) {
+        break;
+    }
+    size_t end = begin + myGrain < myEnd ? begin + myGrain : myEnd;
+    try {
+        Call(begin, end);
+    } catch (...) {
+        {
+            Threads::Lock _l(myErrorMutex);
+            if (!myError) {
+                myError = std::current_exception();
+            }
+        }
+        // Skip the remaining chunks:
+        myNext.store(myEnd, std::memory_order_relaxed);
+        break;
+    }
+ }
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *\
+ *                                                                                       *
+ *     class ThreadPool::Worker:                                                         *
+ *                                                                                       *
+\* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+int ThreadPool::Worker::main(void)
+{
+ myPool.WorkerMain(*this);
+
+ return 0;
+}
+
+/* * * * * * * * * * * * * End - of - File * * * * * * * * * * * * * * */
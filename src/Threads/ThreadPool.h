@@ -0,0 +1,308 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *
+ * Project:     My Generic C++ Library
+ * Purpose:     Work-stealing thread pool
+ * Author:      György Kövesdi (kgy@etiner.hu)
+ * Licence:     GPL (see file 'COPYING' in the project root for more details)
+ * Comments:
+ *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef __SRC_THREADS_THREADPOOL_H_INCLUDED__
+#define __SRC_THREADS_THREADPOOL_H_INCLUDED__
+
+#include <Threads/Threads.h>
+#include <Threads/Mutex.h>
+#include <Threads/Futex.h>
+#include <Threads/WorkDeque.h>
+#include <Memory/Memory.h>
+
+#include <deque>
+#include <vector>
+#include <future>
+#include <atomic>
+#include <exception>
+#include <type_traits>
+#include <utility>
+
+SYS_DECLARE_MODULE(DM_THREAD_POOL);
+
+namespace Threads
+{
+    /// Executes tasks on a fixed number of threads
+    /*! Each worker has its own \ref Threads::WorkDeque, the idle workers steal from the others. The
+     *  tasks of foreign threads go to a common queue. */
+    class ThreadPool: public MEM::noncopyable
+    {
+     public:
+        /*! \param  workers     Number of worker threads, zero means the number of online CPUs. */
+        ThreadPool(unsigned workers = 0, size_t stack = 1024*1024);
+        virtual ~ThreadPool();
+
+        /// Schedules a function to be executed
+        /*! The exceptions of the function are re-thrown by std::future::get(). */
+        template <class F>
+        auto submit(F && func) -> std::future<typename std::result_of<F()>::type>
+        {
+            typedef typename std::result_of<F()>::type ResultType;
+            std::packaged_task<ResultType()> task(std::forward<F>(func));
+            std::future<ResultType> result = task.get_future();
+            Schedule(new TaskImpl<std::packaged_task<ResultType()> >(std::move(task)));
+            return result;
+        }
+
+        /// Calls func(i) for each index in the range [begin, end), the calling thread also works
+        /*! \param  grain   Number of indices in one chunk, zero means automatic.
+         *  \note   The first exception of the function is re-thrown here. */
+        template <class F>
+        void parallel_for(size_t begin, size_t end, F && func, size_t grain = 0)
+        {
+            if (begin >= end) {
+                return;
+            }
+            size_t count = end - begin;
+            if (!grain) {
+                grain = count / (4 * (Size() + 1));
+                if (!grain) {
+                    grain = 1;
+                }
+            }
+            size_t chunks = (count + grain - 1) / grain;
+            if (chunks == 1) {
+                for (size_t i = begin; i < end; ++i) {
+                    func(i);
+                }
+                return;
+            }
+            ParallelFor<typename std::remove_reference<F>::type> job(begin, end, grain, func);
+            unsigned helpers = chunks - 1 < Size() ? chunks - 1 : Size();
+            job.Start(helpers);
+            for (unsigned i = 0; i < helpers; ++i) {
+                Schedule(new ParallelTask(job));
+            }
+            job.Run();
+            WaitFor(job);
+            job.Rethrow();
+        }
+
+        /// Number of worker threads
+        inline unsigned Size(void) const
+        {
+            return myWorkers.size();
+        }
+
+        /// Stops the workers, after executing the tasks already submitted
+        void Finish(void);
+
+     protected:
+        /// Base class of the scheduled tasks
+        class Task
+        {
+         public:
+            virtual ~Task()
+            {
+            }
+
+            virtual void Run(void) =0;
+
+        }; // class ThreadPool::Task
+
+        template <class F>
+        class TaskImpl: public Task
+        {
+         public:
+            inline TaskImpl(F && func):
+                myFunc(std::move(func))
+            {
+            }
+
+            virtual void Run(void) override
+            {
+                myFunc();
+            }
+
+         private:
+            F myFunc;
+
+        }; // class ThreadPool::TaskImpl
+
+        /// Common part of \ref ThreadPool::parallel_for() jobs
+        class ParallelBase
+        {
+         public:
+            inline ParallelBase(size_t begin, size_t end, size_t grain):
+                myNext(begin),
+                myEnd(end),
+                myGrain(grain)
+            {
+            }
+
+            virtual ~ParallelBase()
+            {
+            }
+
+            /// Sets the number of the helper tasks
+            inline void Start(unsigned helpers)
+            {
+                myPending.Store(helpers);
+            }
+
+            /// Processes chunks while there is any
+            void Run(void);
+
+            /// Called by a helper task when it has finished
+            /*! \note   The waiter can destroy the object when the counter reaches zero, the wakeup does not touch it. */
+            inline void Done(void)
+            {
+                if (myPending.Decrement() == 0) {
+                    myPending.WakeAll();
+                }
+            }
+
+            inline Futex & Pending(void)
+            {
+                return myPending;
+            }
+
+            inline void Rethrow(void)
+            {
+                if (myError) {
+                    std::rethrow_exception(myError);
+                }
+            }
+
+         protected:
+            virtual void Call(size_t begin, size_t end) =0;
+
+         private:
+            std::atomic<size_t> myNext;
+
+            size_t myEnd;
+
+            size_t myGrain;
+
+            /// Number of running helper tasks
+            Futex myPending;
+
+            Threads::Mutex myErrorMutex;
+
+            /// The first exception thrown by the function
+            std::exception_ptr myError;
+
+        }; // class ThreadPool::ParallelBase
+
+        template <class F>
+        class ParallelFor: public ParallelBase
+        {
+         public:
+            inline ParallelFor(size_t begin, size_t end, size_t grain, F & func):
+                ParallelBase(begin, end, grain),
+                myFunc(func)
+            {
+            }
+
+         protected:
+            virtual void Call(size_t begin, size_t end) override
+            {
+                for (size_t i = begin; i < end; ++i) {
+                    myFunc(i);
+                }
+            }
+
+         private:
+            F & myFunc;
+
+        }; // class ThreadPool::ParallelFor
+
+        class ParallelTask: public Task
+        {
+         public:
+            inline ParallelTask(ParallelBase & job):
+                myJob(job)
+            {
+            }
+
+            virtual void Run(void) override
+            {
+                myJob.Run();
+                myJob.Done();
+            }
+
+         private:
+            ParallelBase & myJob;
+
+        }; // class ThreadPool::ParallelTask
+
+        class Worker: public Threads::Thread
+        {
+            friend class ThreadPool;
+
+         public:
+            inline Worker(ThreadPool & pool, unsigned index):
+                Threads::Thread("pool-worker"),
+                myPool(pool),
+                myIndex(index)
+            {
+            }
+
+            /// The local queue of this worker
+            WorkDeque<Task *> myTasks;
+
+         protected:
+            virtual int main(void) override;
+
+         private:
+            SYS_DEFINE_CLASS_NAME("Threads::ThreadPool::Worker");
+
+            ThreadPool & myPool;
+
+            unsigned myIndex;
+
+        }; // class ThreadPool::Worker
+
+        typedef MEM::shared_ptr<Worker> WorkerPtr;
+
+        /// Stores the task, it is executed at once if the pool has been finished
+        void Schedule(Task * task);
+
+        /// Waits for the helper tasks of \ref ThreadPool::parallel_for(), executing other tasks meanwhile
+        void WaitFor(ParallelBase & job);
+
+        /// Gets a task to be executed, or nullptr
+        /*! \param  self    The calling worker, or nullptr for other threads. */
+        Task * FindTask(Worker * self);
+
+        /// Executes and deletes the task
+        void Execute(Task * task);
+
+        /// Returns the calling worker if it belongs to this pool
+        Worker * CurrentWorker(void) const;
+
+        /// The body of the worker threads
+        void WorkerMain(Worker & self);
+
+     private:
+        SYS_DEFINE_CLASS_NAME("Threads::ThreadPool");
+
+        std::vector<WorkerPtr> myWorkers;
+
+        /// Tasks submitted from foreign threads
+        std::deque<Task *> myInjected;
+
+        /// The size of \ref ThreadPool::myInjected, without locking
+        std::atomic<size_t> myInjectedSize;
+
+        Threads::Mutex myInjectMutex;
+
+        /// The idle workers are waiting on it
+        EventCount myIdleEvent;
+
+        std::atomic<bool> isFinished;
+
+    }; // class Threads::ThreadPool
+
+} // namespace Threads
+
+#endif /* __SRC_THREADS_THREADPOOL_H_INCLUDED__ */
+
+/* * * * * * * * * * * * * End - of - File * * * * * * * * * * * * * * */
@@ -0,0 +1,185 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *
+ * Project:     My Generic C++ Library
+ * Purpose:     Work-stealing double-ended queue
+ * Author:      György Kövesdi (kgy@etiner.hu)
+ * Licence:     GPL (see file 'COPYING' in the project root for more details)
+ * Comments:    See Threads::ThreadPool for its usage
+ *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef __SRC_THREADS_WORKDEQUE_H_INCLUDED__
+#define __SRC_THREADS_WORKDEQUE_H_INCLUDED__
+
+#include <Threads/Error.h>
+#include <System/Generic.h>
+#include <Memory/Memory.h>
+
+#include <atomic>
+#include <stdint.h>
+#include <type_traits>
+
+namespace Threads
+{
+    /// Chase-Lev work-stealing deque
+    /*! The owner thread pushes and pops at the bottom, the other threads steal from the top.
+     *  \param  T       It must be trivially copyable, e.g. a pointer. */
+    template <typename T>
+    class WorkDeque: public MEM::noncopyable
+    {
+        static_assert(std::is_trivially_copyable<T>::value, "WorkDeque needs trivially copyable elements");
+
+     public:
+        inline WorkDeque(size_t initial_size = 256):
+            myTop(0),
+            myBottom(0),
+            myArray(new Array(RoundUp(initial_size), nullptr))
+        {
+        }
+
+        inline ~WorkDeque()
+        {
+            Array * a = myArray.load(std::memory_order_relaxed);
+            while (a) {
+                Array * previous = a->previous;
+                delete a;
+                a = previous;
+            }
+        }
+
+        /// Stores an element at the bottom
+        /*! \warning    It can be called by the owner thread only. */
+        inline void Push(T p_data)
+        {
+            int64_t b = myBottom.load(std::memory_order_relaxed);
+            int64_t t = myTop.load(std::memory_order_acquire);
+            Array * a = myArray.load(std::memory_order_relaxed);
+            if (b - t > (int64_t)a->mask) {
+                a = Grow(a, t, b);
+            }
+            a->Put(b, p_data);
+            std::atomic_thread_fence(std::memory_order_release);
+            myBottom.store(b + 1, std::memory_order_relaxed);
+        }
+
+        /// Gets the last pushed element
+        /*! \retval false   The deque is empty
+         *  \warning    It can be called by the owner thread only. */
+        inline bool Pop(T & p_data)
+        {
+            int64_t b = myBottom.load(std::memory_order_relaxed) - 1;
+            Array * a = myArray.load(std::memory_order_relaxed);
+            myBottom.store(b, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            int64_t t = myTop.load(std::memory_order_relaxed);
+            if (t > b) {
+                // Empty:
+                myBottom.store(b + 1, std::memory_order_relaxed);
+                return false;
+            }
+            p_data = a->Get(b);
+            if (t == b) {
+                // This is the last one, race against the thieves:
+                bool won = myTop.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+                myBottom.store(b + 1, std::memory_order_relaxed);
+                return won;
+            }
+            return true;
+        }
+
+        /// Gets the oldest element, from any thread
+        /*! \retval false   The deque is empty, or another thread was faster. */
+        inline bool Steal(T & p_data)
+        {
+            int64_t t = myTop.load(std::memory_order_acquire);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            int64_t b = myBottom.load(std::memory_order_acquire);
+            if (t >= b) {
+                return false;
+            }
+            Array * a = myArray.load(std::memory_order_acquire);
+            T result = a->Get(t);
+            if (!myTop.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+                return false;
+            }
+            p_data = result;
+            return true;
+        }
+
+        /// Returns true if the deque is empty
+        /*! \note   This is only a snapshot, the value can be changed by other threads at any time. */
+        inline bool Empty(void) const
+        {
+            return myBottom.load(std::memory_order_relaxed) <= myTop.load(std::memory_order_relaxed);
+        }
+
+     private:
+        struct Array
+        {
+            inline Array(size_t size, Array * prev):
+                mask(size - 1),
+                items(new std::atomic<T>[size]),
+                previous(prev)
+            {
+            }
+
+            inline ~Array()
+            {
+                delete[] items;
+            }
+
+            inline T Get(int64_t index) const
+            {
+                return items[index & mask].load(std::memory_order_relaxed);
+            }
+
+            inline void Put(int64_t index, T p_data)
+            {
+                items[index & mask].store(p_data, std::memory_order_relaxed);
+            }
+
+            size_t mask;
+
+            std::atomic<T> * items;
+
+            /// The previous (smaller) array, it is kept for the thieves
+            Array * previous;
+
+        }; // struct WorkDeque::Array
+
+        inline Array * Grow(Array * a, int64_t t, int64_t b)
+        {
+            Array * result = new Array(2 * (a->mask + 1), a);
+            for (int64_t i = t; i < b; ++i) {
+                result->Put(i, a->Get(i));
+            }
+            myArray.store(result, std::memory_order_release);
+            return result;
+        }
+
+        static inline size_t RoundUp(size_t size)
+        {
+            size_t result = 2;
+            while (result < size) {
+                result *= 2;
+            }
+            return result;
+        }
+
+        /// Index of the oldest element, the thieves take from here
+        std::atomic<int64_t> myTop;
+
+        char myPadding1[CACHE_LINE_SIZE - sizeof(std::atomic<int64_t>)];
+
+        /// Index of the next element to be pushed, it is modified by the owner only
+        std::atomic<int64_t> myBottom;
+
+        std::atomic<Array *> myArray;
+
+    }; // class Threads::WorkDeque
+
+} // namespace Threads
+
+#endif /* __SRC_THREADS_WORKDEQUE_H_INCLUDED__ */
+
+/* * * * * * * * * * * * * End - of - File * * * * * * * * * * * * * * */
@@ -0,0 +1,112 @@
+#include <File/AsyncIo.h>
+#include <iostream>
+#include <vector>
+#include <string.h>
+#include <unistd.h>
+#include "basic-tests.h"
+
+using namespace FILES;
+
+namespace
+{
+    const size_t BLOCK = 4096;
+
+    const size_t BLOCKS = 32;
+
+    /// More blocks than the depth, so the queue is full sometimes
+    const unsigned DEPTH = 8;
+
+    const char * BackendName(AsyncIo::Backend backend)
+    {
+        return backend == AsyncIo::Backend_Uring ? "io_uring" : "threads";
+    }
+}
+
+/// Writes, synchronizes and reads back a file
+/*! The writes are checked by callbacks, the reads are collected by \ref FILES::AsyncIo::ToPipe(). */
+static bool TestBackend(AsyncIo::Backend requested)
+{
+ bool ok = true;
+ int wrong = 0;
+ std::string name = "asyncio-test-" + std::to_string(getpid());
+ FileHandler file("/tmp", name.c_str());
+ file.Open(READ_WRITE);
+ std::vector<char> data(BLOCK * BLOCKS);
+ for (size_t i = 0; i < data.size(); ++i) {
+    data[i] = (char)(i * 13 + i / BLOCK);
+ }
+ std::vector<char> back(BLOCK * BLOCKS);
+ AsyncIo::Backend backend;
+ {
+    AsyncIo io(DEPTH, requested);
+    backend = io.GetBackend();
+
+    // Writes:
+    std::vector<int> written(BLOCKS);
+    for (size_t i = 0; i < BLOCKS; ++i) {
+        io.Write(file, &data[i * BLOCK], BLOCK, i * BLOCK, i, [&](const AsyncIo::Completion & c) {
+            if (c.operation != AsyncIo::Op_Write || c.tag >= BLOCKS || c.fd != file.GetFd() || c.result != (ssize_t)BLOCK) {
+                ++wrong;
+                return;
+            }
+            ++written[c.tag];
+        });
+    }
+    io.Drain();
+    ok &= io.GetPending() == 0;
+    for (size_t i = 0; i < BLOCKS; ++i) {
+        wrong += written[i] != 1;
+    }
+
+    // Fsync:
+    ssize_t synced = -1;
+    io.Fsync(file, 1000, [&](const AsyncIo::Completion & c) {
+        synced = (c.operation == AsyncIo::Op_Fsync && c.tag == 1000) ? c.result : -1;
+    });
+    io.Drain();
+    ok &= synced == 0 && io.GetPending() == 0;
+
+    // Reads, the last one is behind the end of the file:
+    Threads::DataPipe<AsyncIo::Completion, BLOCKS + 1> done;
+    for (size_t i = 0; i < BLOCKS; ++i) {
+        io.Read(file, &back[i * BLOCK], BLOCK, i * BLOCK, i, AsyncIo::ToPipe(done));
+    }
+    char beyond[16];
+    io.Read(file, beyond, sizeof beyond, BLOCK * BLOCKS, BLOCKS, AsyncIo::ToPipe(done));
+    io.Drain();
+    ok &= io.GetPending() == 0 && done.size() == BLOCKS + 1;
+    std::vector<int> read(BLOCKS + 1);
+    for (size_t i = 0; i <= BLOCKS; ++i) {
+        AsyncIo::Completion c = done.pop();
+        if (c.operation != AsyncIo::Op_Read || c.tag > BLOCKS) {
+            ++wrong;
+            continue;
+        }
+        ++read[c.tag];
+        wrong += c.result != (c.tag == BLOCKS ? 0 : (ssize_t)BLOCK);
+    }
+    for (size_t i = 0; i <= BLOCKS; ++i) {
+        wrong += read[i] != 1;
+    }
+    ok &= memcmp(data.data(), back.data(), data.size()) == 0;
+
+    // The queued operations are dropped by the destructor, without calling the callbacks:
+    io.Read(file, &back[0], BLOCK, 0, 2000, [&](const AsyncIo::Completion &) {
+        ++wrong;
+    });
+    ok &= io.GetPending() == 1;
+ }
+ file.Remove();
+ ok &= wrong == 0;
+ std::cout << "* AsyncIo " << BackendName(backend) << ": " << (ok ? "ok" : "WRONG") << ", " << wrong << " error(s)" << std::endl;
+ return ok;
+}
+
+bool TestAsyncIo(void)
+{
+ bool ok = TestBackend(AsyncIo::Backend_Auto);
+ ok &= TestBackend(AsyncIo::Backend_Threads);
+ return ok;
+}
+
+/* * * * * * * * * * * * * End - of - File * * * * * * * * * * * * * * */
@@ -0,0 +1,34 @@
+#ifndef __BASIC_TESTS_H__
+#define __BASIC_TESTS_H__
+
+// Tests of the primitives, called from main(); each returns true on success:
+
+bool TestRingPipe(void);
+
+bool TestWorkDeque(void);
+
+bool TestSeqLock(void);
+
+bool TestIntrusivePtr(void);
+
+bool TestObjectPool(void);
+
+bool TestChainBuffer(void);
+
+bool TestBitOps(void);
+
+bool TestThreadArray(void);
+
+bool TestAsyncIo(void);
+
+bool TestTimedWait(void);
+
+bool TestBinaryReader(void);
+
+bool TestFileMap(void);
+
+bool TestDataPipe(void);
+
+#endif /* __BASIC_TESTS_H__ */
+
+/* * * * * * * * * * * * * End - of - File * * * * * * * * * * * * * * */
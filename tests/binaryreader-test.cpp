@@ -0,0 +1,219 @@
+#include <File/BinaryReader.h>
+#include <File/BufferedReader.h>
+#include <iostream>
+#include <vector>
+#include <string.h>
+#include <unistd.h>
+#include "basic-tests.h"
+
+using namespace FILES;
+
+namespace
+{
+    /// Small buffer, so the records straddle the block boundaries
+    const size_t BUFFER = 64;
+
+    const uint32_t RECORDS = 200;
+
+    /// Larger than the buffer, even after it grew
+    const size_t LARGE = 1000;
+
+    /// The buffer must grow for this
+    const size_t GROWTH = 300;
+
+    const size_t SKIPPED = 500;
+
+    /// The stored part of the last blob, its length field tells the double
+    const uint32_t TRUNCATED = 10;
+
+    struct Record
+    {
+        uint32_t seq;
+        uint32_t check;
+    };
+
+    /// The expected content of the file
+    class Image: public std::vector<char>
+    {
+     public:
+        void Append(const void * data, size_t size)
+        {
+            insert(end(), (const char *)data, (const char *)data + size);
+        }
+
+        void Pattern(size_t size)
+        {
+            for (size_t i = 0; i < size; ++i) {
+                push_back((char)(this->size() * 7 + 3));
+            }
+        }
+
+        bool Equals(off_t offset, const void * data, size_t size) const
+        {
+            return offset >= 0 && offset + size <= this->size() && !memcmp(this->data() + offset, data, size);
+        }
+    };
+
+    uint32_t BlobLength(uint32_t seq)
+    {
+        return (seq * 13) % 37;
+    }
+
+    /// Note: the file is not truncated when opened, so each image gets its own name
+    void WriteFile(const std::string & name, const Image & image)
+    {
+        FileHandler file("/tmp", name.c_str());
+        file.Open(READ_WRITE);
+        file.Write(image.data(), image.size());
+    }
+}
+
+/// Reads the records, blobs and areas of the image by one reader
+static bool TestBinary(const std::string & name, const Image & image)
+{
+ bool ok = true;
+ FileHandler file("/tmp", name.c_str());
+ file.Open(READ_ONLY);
+ BinaryReader reader(file, BUFFER);
+
+ // Small records and blobs, the buffer is compacted many times:
+ for (uint32_t i = 0; i < RECORDS; ++i) {
+    Record record;
+    ok &= reader.Read(record) && record.seq == i && record.check == ~i;
+    if (i % 5 == 4) {
+        uint32_t length = 0;
+        ok &= reader.Read(length) && length == BlobLength(i);
+        reader.Skip(length);
+        continue;
+    }
+    BinaryReader::Span blob;
+    off_t offset = reader.Tell();
+    ok &= reader.ReadBlob(blob) && blob.size() == BlobLength(i) && image.Equals(offset + sizeof(uint32_t), blob.data(), blob.size());
+ }
+
+ // The buffer grows:
+ off_t offset = reader.Tell();
+ BinaryReader::Span peek = reader.Peek(GROWTH);
+ ok &= peek.size() == GROWTH && image.Equals(offset, peek.data(), peek.size()) && reader.Tell() == offset;
+
+ // Read directly into the record:
+ std::vector<char> large(LARGE);
+ ok &= reader.Read(large.data(), large.size()) && image.Equals(offset, large.data(), large.size());
+ ok &= reader.Tell() == offset + (off_t)LARGE;
+
+ // Skip beyond the buffer:
+ reader.Skip(SKIPPED);
+ offset += LARGE + SKIPPED;
+ ok &= reader.Tell() == offset;
+
+ // The blob is longer than the rest of the file:
+ ok &= reader.Peek(2 * TRUNCATED).size() == sizeof(uint32_t) + TRUNCATED;
+ try {
+    BinaryReader::Span blob;
+    reader.ReadBlob(blob);
+    ok = false;
+ } catch (EX::File_EOF & ex) {
+    ok &= ex.GetBytes() == TRUNCATED;
+ }
+ ok &= !reader.eof() && reader.Tell() == offset + (off_t)sizeof(uint32_t);
+ BinaryReader::Span rest = reader.Consume(TRUNCATED);
+ ok &= image.Equals(reader.Tell() - TRUNCATED, rest.data(), rest.size());
+ ok &= reader.eof() && reader.Tell() == (off_t)image.size();
+
+ // Clean EOF:
+ Record record;
+ BinaryReader::Span blob;
+ ok &= !reader.Read(record) && !reader.ReadBlob(blob) && reader.Peek(1).size() == 0;
+
+ std::cout << "* BinaryReader records: " << (ok ? "ok" : "WRONG") << std::endl;
+ return ok;
+}
+
+/// Incomplete records and areas at the end of the file
+static bool TestBinaryEOF(const std::string & name, const Image & image)
+{
+ bool ok = true;
+ FileHandler file("/tmp", name.c_str());
+ file.Open(READ_ONLY);
+ BinaryReader reader(file, BUFFER);
+
+ reader.Skip(image.size() - 3);
+ try {
+    Record record;
+    reader.Read(record);
+    ok = false;
+ } catch (EX::File_EOF & ex) {
+    ok &= ex.GetBytes() == 3;
+ }
+
+ FileHandler file2("/tmp", name.c_str());
+ file2.Open(READ_ONLY);
+ BinaryReader reader2(file2, BUFFER);
+ reader2.Skip(image.size() - 3);
+ try {
+    reader2.Consume(4);
+    ok = false;
+ } catch (EX::File_EOF & ex) {
+    ok &= ex.GetBytes() == 3;
+ }
+ try {
+    reader2.Skip(4);
+    ok = false;
+ } catch (EX::File_EOF &) {
+ }
+
+ std::cout << "* BinaryReader EOF: " << (ok ? "ok" : "WRONG") << std::endl;
+ return ok;
+}
+
+/// Reads the file byte-by-byte, then checks that EOF is returned repeatedly
+template <unsigned SIZE>
+static bool TestBuffered(const std::string & name, const Image & image)
+{
+ bool ok = true;
+ BufferedReader<SIZE> reader("/tmp/" + name);
+ reader.Open();
+ size_t count = 0;
+ for (int c; (c = reader.ReadByte()) != EOF; ++count) {
+    ok &= count < image.size() && c == (uint8_t)image[count];
+ }
+ ok &= count == image.size();
+ ok &= reader.ReadByte() == EOF && reader.ReadByte() == EOF;
+ std::cout << "* BufferedReader<" << SIZE << ">: " << (ok ? "ok" : "WRONG") << ", " << count << " bytes, " << (image.size() % SIZE ? "partial" : "full") << " last block" << std::endl;
+ return ok;
+}
+
+bool TestBinaryReader(void)
+{
+ bool ok = true;
+ std::string name = "binaryreader-test-" + std::to_string(getpid());
+
+ Image image;
+ for (uint32_t i = 0; i < RECORDS; ++i) {
+    Record record = { i, ~i };
+    image.Append(&record, sizeof record);
+    uint32_t length = BlobLength(i);
+    image.Append(&length, sizeof length);
+    image.Pattern(length);
+ }
+ image.Pattern(LARGE + SKIPPED);
+ uint32_t claimed = 2 * TRUNCATED;
+ image.Append(&claimed, sizeof claimed);
+ image.Pattern(TRUNCATED);
+ WriteFile(name, image);
+ ok &= TestBinary(name, image);
+ ok &= TestBinaryEOF(name, image);
+
+ // The EOF is found in the middle of a block, or by the next read after a full block:
+ Image bytes;
+ bytes.Pattern(BUFFER * 37);
+ WriteFile(name + ".txt", bytes);
+ ok &= TestBuffered<BUFFER>(name + ".txt", bytes);
+ ok &= TestBuffered<48>(name + ".txt", bytes);
+
+ FileHandler("/tmp", name.c_str()).Remove();
+ FileHandler("/tmp", (name + ".txt").c_str()).Remove();
+ return ok;
+}
+
+/* * * * * * * * * * * * * End - of - File * * * * * * * * * * * * * * */
@@ -0,0 +1,142 @@
+#include <File/BitOps.h>
+#include <iostream>
+#include <string.h>
+#include "basic-tests.h"
+
+using namespace FILES;
+
+namespace
+{
+    /// Deterministic pseudo-random bytes
+    uint8_t Random(void)
+    {
+        static uint32_t state = 12345;
+        state = state * 1103515245 + 12345;
+        return state >> 16;
+    }
+
+    inline bool Bit(const uint8_t * data, size_t index)
+    {
+        return data[index / 8] & (1u << (index % 8));
+    }
+
+    const size_t BYTES = 200;
+}
+
+/// Compares the functions to the bit-by-bit reference
+/*! The sizes and ranges are not multiples of 8, and the bits behind the end are set, they must be
+    ignored. The lengths cross the word and vector boundaries of all the implementations. */
+static bool TestRanges(void)
+{
+ int wrong = 0;
+ uint8_t data[BYTES];
+ for (size_t bits = 0; bits <= 8 * 80; bits += (bits < 140) ? 1 : 13) {
+    for (size_t i = 0; i < BYTES; ++i) {
+        data[i] = Random();
+    }
+    // Dense ones, sparse ones, and all the same bits:
+    if (bits % 4 == 1) {
+        memset(data, 0, bits / 8);
+    } else if (bits % 4 == 2) {
+        memset(data, 0xff, bits / 8);
+    }
+    size_t count = 0;
+    for (size_t i = 0; i < bits; ++i) {
+        count += Bit(data, i);
+    }
+    wrong += BitOps::Count(data, bits) != count;
+    for (size_t from = 0; from <= bits + 1; from += (from < 20) ? 1 : 7) {
+        size_t set = from < bits ? from : bits;
+        while (set < bits && !Bit(data, set)) {
+            ++set;
+        }
+        size_t clear = from < bits ? from : bits;
+        while (clear < bits && Bit(data, clear)) {
+            ++clear;
+        }
+        wrong += BitOps::FindFirstSet(data, from, bits) != set;
+        wrong += BitOps::FindFirstClear(data, from, bits) != clear;
+    }
+ }
+ std::cout << "* BitOps count and find: " << wrong << " error(s)" << std::endl;
+ return !wrong;
+}
+
+/// Sets and clears ranges; the bits outside the range must not be changed
+static bool TestFill(void)
+{
+ int wrong = 0;
+ uint8_t data[BYTES];
+ uint8_t original[BYTES];
+ for (size_t begin = 0; begin < 30; ++begin) {
+    for (size_t end = 0; end < 8 * 40; end += (end < 40) ? 1 : 11) {
+        for (int set = 0; set < 2; ++set) {
+            for (size_t i = 0; i < BYTES; ++i) {
+                original[i] = data[i] = Random();
+            }
+            if (set) {
+                BitOps::SetRange(data, begin, end);
+            } else {
+                BitOps::ClearRange(data, begin, end);
+            }
+            for (size_t i = 0; i < 8 * BYTES; ++i) {
+                bool expected = (i >= begin && i < end) ? set : Bit(original, i);
+                wrong += Bit(data, i) != expected;
+            }
+        }
+    }
+ }
+ std::cout << "* BitOps set and clear: " << wrong << " error(s)" << std::endl;
+ return !wrong;
+}
+
+/// The logical operations on unaligned arrays, the bytes behind the end must not be changed
+static bool TestLogic(void)
+{
+ int wrong = 0;
+ uint8_t dst[BYTES + 8];
+ uint8_t src[BYTES + 8];
+ uint8_t original[BYTES + 8];
+ for (size_t bytes = 0; bytes < 100; ++bytes) {
+    for (int op = 0; op < 4; ++op) {
+        size_t offset = bytes % 8;
+        for (size_t i = 0; i < sizeof(dst); ++i) {
+            original[i] = dst[i] = Random();
+            src[i] = Random();
+        }
+        uint8_t * d = dst + offset;
+        const uint8_t * s = src + (offset + 3) % 8;
+        switch (op) {
+            case 0: BitOps::And(d, s, bytes); break;
+            case 1: BitOps::Or(d, s, bytes); break;
+            case 2: BitOps::Xor(d, s, bytes); break;
+            case 3: BitOps::AndNot(d, s, bytes); break;
+        }
+        for (size_t i = 0; i < sizeof(dst); ++i) {
+            uint8_t expected = original[i];
+            if (i >= offset && i < offset + bytes) {
+                uint8_t b = s[i - offset];
+                switch (op) {
+                    case 0: expected &= b; break;
+                    case 1: expected |= b; break;
+                    case 2: expected ^= b; break;
+                    case 3: expected &= ~b; break;
+                }
+            }
+            wrong += dst[i] != expected;
+        }
+    }
+ }
+ std::cout << "* BitOps logic (" << BitOps::GetImplementation() << "): " << wrong << " error(s)" << std::endl;
+ return !wrong;
+}
+
+bool TestBitOps(void)
+{
+ bool ok = TestRanges();
+ ok &= TestFill();
+ ok &= TestLogic();
+ return ok;
+}
+
+/* * * * * * * * * * * * * End - of - File * * * * * * * * * * * * * * */
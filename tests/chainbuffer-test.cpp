@@ -0,0 +1,80 @@
+#include <File/ChainBuffer.h>
+#include <iostream>
+#include "basic-tests.h"
+
+static inline char Pattern(size_t index)
+{
+ return (char)(index * 7 + 3);
+}
+
+/// Writes 'size' bytes of the test pattern, in pieces of 'piece' bytes
+static void Fill(FILES::ChainBuffer & buffer, size_t size, size_t piece)
+{
+ char data[1000];
+ for (size_t done = 0; done < size; ) {
+    size_t n = size - done < piece ? size - done : piece;
+    for (size_t i = 0; i < n; ++i) {
+        data[i] = Pattern(done + i);
+    }
+    buffer.Write(data, n);
+    done += n;
+ }
+}
+
+static bool Check(FILES::Block & block, size_t size)
+{
+ if (block.GetSize() != size) {
+    return false;
+ }
+ for (size_t i = 0; i < size; ++i) {
+    if (block.get()[i] != Pattern(i)) {
+        return false;
+    }
+ }
+ return true;
+}
+
+/// Detaches the contents stored in one segment, or in several ones
+/*! The data in one segment is taken out without copying, while more segments are copied into one
+    block. The buffer must be empty and reusable after both. */
+bool TestChainBuffer(void)
+{
+ bool ok = true;
+ FILES::ChainBuffer buffer;
+
+ // Nothing:
+ FILES::Block empty = buffer.Detach();
+ ok &= empty.GetSize() == 0 && !empty.get();
+
+ // Inline only:
+ Fill(buffer, 100, 30);
+ FILES::Block small = buffer.Detach();
+ ok &= Check(small, 100) && buffer.empty();
+
+ // One reserved segment, it is taken out:
+ buffer.reserve(10000);
+ Fill(buffer, 10000, 999);
+ ok &= buffer.GetSegmentCount() == 2 && buffer.GetSegment(1).size == 10000;
+ const char * segment = buffer.GetSegment(1).data;
+ FILES::Block one = buffer.Detach();
+ ok &= Check(one, 10000) && one.get() == segment && buffer.empty();
+ ok &= buffer.GetSegmentCount() == 1;
+
+ // Several segments, they are copied and kept for reuse:
+ Fill(buffer, 50000, 1000);
+ size_t segments = buffer.GetSegmentCount();
+ ok &= segments > 2;
+ FILES::Block several = buffer.Detach();
+ ok &= Check(several, 50000) && buffer.empty() && buffer.GetSegmentCount() == segments;
+
+ // Reused without allocation:
+ Fill(buffer, 50000, 700);
+ ok &= buffer.GetSegmentCount() == segments;
+ FILES::Block again = buffer.Detach();
+ ok &= Check(again, 50000);
+
+ std::cout << "* ChainBuffer: " << (ok ? "ok" : "WRONG") << ", " << segments << " segments" << std::endl;
+ return ok;
+}
+
+/* * * * * * * * * * * * * End - of - File * * * * * * * * * * * * * * */
@@ -0,0 +1,156 @@
+#include <Threads/DataPipe.h>
+#include <chrono>
+#include <iostream>
+#include <iterator>
+#include <memory>
+#include <thread>
+#include <vector>
+#include "basic-tests.h"
+
+namespace
+{
+    typedef std::unique_ptr<int> Element;
+
+    typedef std::vector<Element> Batch;
+
+    size_t PushBatch(Threads::DataPipe<Element, 16> & pipe, Batch & batch)
+    {
+        return pipe.push_many(std::make_move_iterator(batch.begin()), std::make_move_iterator(batch.end()));
+    }
+}
+
+/// Passes move-only elements in batches by several producers and consumers
+/*! The batches are often larger than the pipe, so the producers are blocked in the middle of
+    them. Each element must be received exactly once, and the elements of one producer must be
+    received in order by each consumer. */
+static bool TestBatches(void)
+{
+ static const int producers = 2;
+ static const int consumers = 4;
+ static const int count = 20000;
+ Threads::DataPipe<Element, 16> pipe;
+ bool ok = true;
+ std::vector<std::thread> threads;
+ std::vector<int> pushed(producers);
+ for (int i = 0; i < producers; ++i) {
+    threads.push_back(std::thread([&pipe, &pushed, i]() {
+        Batch batch;
+        for (int j = 0; j < count; ) {
+            batch.clear();
+            for (int k = j % 37; k >= 0 && j < count; --k, ++j) {
+                batch.push_back(Element(new int(j * producers + i)));
+            }
+            pushed[i] += PushBatch(pipe, batch);
+            for (size_t k = 0; k < batch.size(); ++k) {
+                pushed[i] -= batch[k] != nullptr;   // Must have been moved
+            }
+        }
+    }));
+ }
+ std::vector<Batch> received(consumers);
+ for (int i = 0; i < consumers; ++i) {
+    threads.push_back(std::thread([&pipe, &received, i]() {
+        while (pipe.pop_many(std::back_inserter(received[i]), 8)) {
+        }
+    }));
+ }
+ for (int i = 0; i < producers; ++i) {
+    threads[i].join();
+    ok &= pushed[i] == count;
+ }
+ pipe.finish();
+ for (int i = producers; i < producers + consumers; ++i) {
+    threads[i].join();
+ }
+ std::vector<int> seen(producers * count);
+ size_t total = 0;
+ for (int i = 0; i < consumers; ++i) {
+    std::vector<int> last(producers, -1);
+    for (size_t j = 0; j < received[i].size(); ++j) {
+        const Element & element = received[i][j];
+        if (!element || *element < 0 || *element >= producers * count) {
+            ok = false;
+            continue;
+        }
+        int value = *element;
+        ok &= value > last[value % producers];
+        last[value % producers] = value;
+        ++seen[value];
+    }
+    total += received[i].size();
+ }
+ for (size_t i = 0; i < seen.size(); ++i) {
+    ok &= seen[i] == 1;
+ }
+ std::cout << "* DataPipe batches: " << (ok ? "ok" : "WRONG") << ", received " << total << " of " << producers * count << std::endl;
+ return ok && pipe.size() == 0;
+}
+
+/// One batch must wake up all the blocked consumers
+/*! The consumers not woken up would get the elements only after their timeout. */
+static bool TestBatchWakeup(void)
+{
+ static const int consumers = 4;
+ Threads::DataPipe<Element, 16> pipe;
+ std::vector<size_t> got(consumers);
+ std::vector<Batch> received(consumers);
+ std::vector<std::thread> threads;
+ for (int i = 0; i < consumers; ++i) {
+    threads.push_back(std::thread([&pipe, &got, &received, i]() {
+        got[i] = pipe.pop_many(std::back_inserter(received[i]), 1, 2000);
+    }));
+ }
+ std::this_thread::sleep_for(std::chrono::milliseconds(100));
+ Batch batch;
+ for (int i = 0; i < consumers; ++i) {
+    batch.push_back(Element(new int(i)));
+ }
+ std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+ bool ok = PushBatch(pipe, batch) == consumers;
+ for (int i = 0; i < consumers; ++i) {
+    threads[i].join();
+    ok &= got[i] == 1 && received[i].size() == 1 && received[i][0];
+ }
+ double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+ ok &= elapsed < 1.0;
+ std::cout << "* DataPipe batch wakeup: " << (ok ? "ok" : "WRONG") << ", " << elapsed << "s" << std::endl;
+ return ok;
+}
+
+/// push_many() stops at finish(), even if it is called before
+static bool TestBatchFinish(void)
+{
+ bool ok = true;
+ {
+    Threads::DataPipe<Element, 16> pipe;
+    Batch batch(20);
+    size_t stored = 0;
+    std::thread producer([&pipe, &batch, &stored]() {
+        stored = PushBatch(pipe, batch);
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    pipe.finish();
+    producer.join();
+    ok &= stored == 16 && pipe.size() == 16;
+ }
+ {
+    Threads::DataPipe<Element, 16> pipe;
+    Batch full(16);
+    ok &= PushBatch(pipe, full) == 16;
+    pipe.finish();
+    Batch batch(20);
+    ok &= PushBatch(pipe, batch) == 0;
+ }
+ std::cout << "* DataPipe batch finish: " << (ok ? "ok" : "WRONG") << std::endl;
+ return ok;
+}
+
+bool TestDataPipe(void)
+{
+ bool ok = TestBatches();
+ ok &= TestBatchWakeup();
+ ok &= TestBatchFinish();
+ return ok;
+}
+
+/* * * * * * * * * * * * * End - of - File * * * * * * * * * * * * * * */
@@ -0,0 +1,144 @@
+#include <File/FileMapTyped.h>
+#include <File/FileMapWindowed.h>
+#include <iostream>
+#include <string>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include "basic-tests.h"
+
+using namespace FILES;
+
+namespace
+{
+    /// Each line is "%07u\n"
+    const size_t LINE = 8;
+
+    /// Lines read before the file is extended
+    const unsigned READ_FIRST = 100;
+
+    void WriteLines(char * data, size_t from, size_t to)
+    {
+        char line[LINE + 1];
+        for (size_t i = from; i < to; ++i) {
+            snprintf(line, sizeof line, "%07u\n", (unsigned)i);
+            memcpy(data + i * LINE, line, LINE);
+        }
+    }
+
+    bool ReadLines(FileMap_char & reader, size_t from, size_t to)
+    {
+        bool ok = true;
+        char line[LINE + 1];
+        for (size_t i = from; i < to; ++i) {
+            snprintf(line, sizeof line, "%07u", (unsigned)i);
+            MEM::Span<const char> got = reader.ReadLine();
+            ok &= got.size() == LINE - 1 && !memcmp(got.data(), line, LINE - 1);
+        }
+        return ok;
+    }
+
+    /// Checks if the page at the address is mapped
+    bool isMapped(const char * address)
+    {
+        unsigned char vec;
+        return mincore(const_cast<char *>(address), 1, &vec) == 0;
+    }
+}
+
+/// A writer extends the file, while a reader follows it by Refresh()
+/*! The address after the mapping of the reader is reserved, so the mapping must be moved, and the
+    read position must be rebased. */
+static bool TestGrowing(const std::string & name)
+{
+ bool ok = true;
+ size_t page = getpagesize();
+ unlink(name.c_str());
+
+ FileMap writer(name.c_str(), (FileMap::OpenMode)(FileMap::Read_Write | FileMap::Map_Truncate), page);
+ WriteLines((char *)writer.GetData(), 0, page / LINE);
+
+ FileMap_char reader(name.c_str());
+ ok &= reader.GetSize() == page;
+ ok &= ReadLines(reader, 0, READ_FIRST) && reader.GetPosition() == (off_t)(READ_FIRST * LINE);
+
+ const char * old_address = (const char *)reader.GetData();
+ void * hint = (char *)reader.GetData() + page;
+ void * guard = mmap(hint, page, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+ ok &= guard != MAP_FAILED;
+
+ writer.Extend(3 * page);
+ WriteLines((char *)writer.GetData(), page / LINE, 3 * page / LINE);
+
+ ok &= reader.Refresh() && !reader.Refresh();
+ bool moved = reader.GetData() != old_address;
+ ok &= moved && reader.GetSize() == 3 * page && reader.GetPosition() == (off_t)(READ_FIRST * LINE);
+ ok &= ReadLines(reader, READ_FIRST, 3 * page / LINE) && reader.ChrGet() == -1;
+
+ munmap(guard, page);
+ unlink(name.c_str());
+
+ std::cout << "* FileMap growing: " << (ok ? "ok" : "WRONG") << ", " << (moved ? "moved" : "not moved") << std::endl;
+ return ok;
+}
+
+/// Windows of one page, at most two of them
+static bool TestWindowed(const std::string & name)
+{
+ bool ok = true;
+ size_t page = getpagesize();
+ unlink(name.c_str());
+
+ FileMap_windowed writer(name, FileMap::Read_Write, page, 2);
+ writer.Extend(4 * page + 100);
+ for (size_t i = 0; i < 4; ++i) {
+    memset(writer.GetWritable(i * page, page), 'a' + i, page);
+    ok &= writer.GetWindowCount() <= 2;
+ }
+
+ FileMap_windowed reader(name, FileMap::Read_Only, page, 2);
+ ok &= reader.GetSize() == 4 * page + 100;
+ const char * p0 = reader.Get(0, 1);
+ const char * p1 = reader.Get(page, 1);
+ ok &= *p0 == 'a' && *p1 == 'b' && reader.GetWindowCount() == 2;
+
+ // The window of 'p1' is the least recently used one:
+ ok &= reader.Get(0, 1) == p0;
+ const char * p2 = reader.Get(2 * page, 1);
+ ok &= *p2 == 'c' && reader.GetWindowCount() == 2;
+ ok &= isMapped(p0) && *p0 == 'a';
+
+ // Crossing the window boundary:
+ const char * cross = reader.Get(2 * page - 8, 16);
+ ok &= !memcmp(cross, "bbbbbbbbcccccccc", 16) && reader.GetWindowCount() == 2;
+
+ // Appended data, in a window already mapped:
+ const char * tail = reader.Get(4 * page, 100);
+ writer.Extend(4 * page + 200);
+ memset(writer.GetWritable(4 * page + 100, 100), 'x', 100);
+ ok &= reader.GetSize() == 4 * page + 100;
+ ok &= reader.Get(4 * page + 150, 50) == tail + 150 && tail[199] == 'x' && reader.GetSize() == 4 * page + 200;
+
+ try {
+    reader.Get(4 * page + 150, 51);
+    ok = false;
+ } catch (EX::File_EOF & ex) {
+    ok &= ex.GetBytes() == 50;
+ }
+
+ unlink(name.c_str());
+
+ std::cout << "* FileMap windowed: " << (ok ? "ok" : "WRONG") << std::endl;
+ return ok;
+}
+
+bool TestFileMap(void)
+{
+ std::string name = "/tmp/filemap-test-" + std::to_string(getpid());
+ bool ok = TestGrowing(name);
+ ok &= TestWindowed(name);
+ return ok;
+}
+
+/* * * * * * * * * * * * * End - of - File * * * * * * * * * * * * * * */
@@ -0,0 +1,111 @@
+#include <Memory/Memory.h>
+#include <iostream>
+#include <thread>
+#include <vector>
+#include "basic-tests.h"
+
+namespace
+{
+    std::atomic<int> objects(0);
+
+    class Base: public MEM::RefCounted<Base>
+    {
+     public:
+        Base(void)
+        {
+            ++objects;
+        }
+
+        virtual ~Base()
+        {
+            --objects;
+        }
+    };
+
+    class Derived: public Base
+    {
+    };
+
+    /// Not thread-safe variant
+    class Local: public MEM::RefCounted<Local, int>
+    {
+     public:
+        Local(void)
+        {
+            ++objects;
+        }
+
+        ~Local()
+        {
+            --objects;
+        }
+    };
+}
+
+/// Copying, moving and converting pointers in one thread
+static bool TestPointers(void)
+{
+ bool ok = true;
+ {
+    MEM::intrusive_ptr<Derived> derived(new Derived);
+    MEM::intrusive_ptr<Base> base(derived);
+    MEM::intrusive_ptr<Base> moved(std::move(base));
+    ok &= !base && moved == derived && objects == 1;
+    MEM::intrusive_ptr<Base> other(new Base);
+    ok &= objects == 2;
+    other = moved;
+    ok &= objects == 1 && other == derived;
+    derived.reset();
+    moved.reset();
+    ok &= objects == 1;
+    other.reset(new Derived);
+    ok &= objects == 1;
+ }
+ ok &= objects == 0;
+ {
+    MEM::intrusive_ptr<Local> first(new Local);
+    MEM::intrusive_ptr<Local> second(first);
+    first.reset();
+    ok &= objects == 1;
+ }
+ ok &= objects == 0;
+ std::cout << "* intrusive_ptr: " << (ok ? "ok" : "WRONG") << std::endl;
+ return ok;
+}
+
+/// Threads copy and drop the pointer to the same object
+/*! The object must be deleted exactly once, when the last pointer has been dropped. */
+static bool TestThreads(void)
+{
+ static const int threads = 4;
+ static const int rounds = 100000;
+ MEM::intrusive_ptr<Base> shared(new Derived);
+ std::vector<std::thread> workers;
+ for (int i = 0; i < threads; ++i) {
+    workers.push_back(std::thread([shared]() {
+        for (int j = 0; j < rounds; ++j) {
+            MEM::intrusive_ptr<Base> copy(shared);
+            MEM::intrusive_ptr<Base> moved(std::move(copy));
+        }
+    }));
+ }
+ bool ok = true;
+ for (std::thread & worker: workers) {
+    worker.join();
+ }
+ // The lambdas have been destroyed with the threads, so this is the last reference:
+ ok &= objects == 1;
+ shared.reset();
+ ok &= objects == 0;
+ std::cout << "* intrusive_ptr threads: " << (ok ? "ok" : "WRONG") << std::endl;
+ return ok;
+}
+
+bool TestIntrusivePtr(void)
+{
+ bool ok = TestPointers();
+ ok &= TestThreads();
+ return ok;
+}
+
+/* * * * * * * * * * * * * End - of - File * * * * * * * * * * * * * * */
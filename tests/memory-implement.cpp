@@ -40,4 +40,23 @@ AUTON_IMPLEMENT_PRIO(X3, I2, 3);
 AUTON_IMPLEMENT_PRIO(M1, I1, 1);
 AUTON_IMPLEMENT_PRIO(X1, I2, 1);
 
+class N1: public I3
+{
+ public:
+    N1()
+    {
+        ++instances;
+    }
+    ~N1()
+    {
+        --instances;
+    }
+    virtual int n()
+    {
+        return instances;
+    }
+};
+
+AUTON_IMPLEMENT(N1, I3);
+
 /* * * * * * * * * * * * * End - of - File * * * * * * * * * * * * * * */
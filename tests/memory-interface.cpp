@@ -2,5 +2,8 @@
 
 AUTON_INTERFACE(I1);
 AUTON_INTERFACE(I2);
+AUTON_INTERFACE(I3);
+
+std::atomic<int> I3::instances;
 
 /* * * * * * * * * * * * * End - of - File * * * * * * * * * * * * * * */
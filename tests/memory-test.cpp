@@ -1,9 +1,43 @@
 #include <Debug/Debug.h>
 #include <iostream>
+#include <thread>
+#include <vector>
 #include "memory-test.h"
+#include "basic-tests.h"
+
+/// Uses the Interface I3 from several threads at the same time
+/*! Each thread creates and drops its own pointers, so the Implementation is created and deleted
+    many times in parallel. It must be a singleton, and must be deleted at the end. */
+static bool TestAutonThreads(void)
+{
+ static const int threads = 4;
+ static const int rounds = 100000;
+ std::atomic<int> errors(0);
+ std::vector<std::thread> workers;
+ for (int i = 0; i < threads; ++i) {
+    workers.push_back(std::thread([&errors]() {
+        for (int j = 0; j < rounds; ++j) {
+            Auton<I3> pointer;
+            if (pointer->n() != 1) {
+                ++errors;
+            }
+            Auton<I3> copy;
+            if (copy.Instance() != pointer.Instance()) {
+                ++errors;
+            }
+        }
+    }));
+ }
+ for (std::thread & worker: workers) {
+    worker.join();
+ }
+ std::cout << "* Threads: " << errors << " error(s), " << I3::instances << " instance(s) left" << std::endl;
+ return errors == 0 && I3::instances == 0;
+}
 
 int main(int argc, char ** argv)
 {
+ bool ok = true;
  std::cout << "* Started ------------------ " << std::endl;
  {
     Auton<I1> interface;
@@ -14,10 +48,6 @@ int main(int argc, char ** argv)
     std::cout << interface->n() << std::endl;
     std::cout << interface->n() << std::endl;
     std::cout << "* " << (interface.IsValid() ? "valid" : "not valid") << std::endl;
-    std::cout << "* Destroying:" << std::endl;
-    interface.Destroy();
-    std::cout << "* Destroyed." << std::endl;
-    std::cout << "* " << (interface.IsValid() ? "valid" : "not valid") << std::endl;
     std::cout << interface->n() << std::endl;
     std::cout << interface->n() << std::endl;
  }
@@ -33,10 +63,6 @@ int main(int argc, char ** argv)
     std::cout << interface->n() << std::endl;
     std::cout << interface->n() << std::endl;
     std::cout << "* " << (interface.IsValid() ? "valid" : "not valid") << std::endl;
-    std::cout << "* Destroying:" << std::endl;
-    interface.Destroy();
-    std::cout << "* Destroyed." << std::endl;
-    std::cout << "* " << (interface.IsValid() ? "valid" : "not valid") << std::endl;
     std::cout << interface->n() << std::endl;
     std::cout << "Force to 'M2': " << (AUTON_FORCE(I1, "M2") ? "succeeded" : "failed") << std::endl;
     std::cout << "Force to 'M1': " << (AUTON_FORCE(I1, "M1") ? "succeeded" : "failed") << std::endl;
@@ -44,8 +70,24 @@ int main(int argc, char ** argv)
     std::cout << "Force to 'ABC': " << (AUTON_FORCE(I1, "ABC") ? "succeeded" : "failed") << std::endl;
     std::cout << interface->n() << std::endl;
  }
+ std::cout << "* Threads ------------------ " << std::endl;
+ ok &= TestAutonThreads();
+ std::cout << "* Primitives --------------- " << std::endl;
+ ok &= TestRingPipe();
+ ok &= TestWorkDeque();
+ ok &= TestSeqLock();
+ ok &= TestIntrusivePtr();
+ ok &= TestObjectPool();
+ ok &= TestChainBuffer();
+ ok &= TestBitOps();
+ ok &= TestThreadArray();
+ ok &= TestAsyncIo();
+ ok &= TestTimedWait();
+ ok &= TestBinaryReader();
+ ok &= TestFileMap();
+ ok &= TestDataPipe();
  std::cout << "* Exited -------------------- " << std::endl;
- return 0;
+ return ok ? 0 : 1;
 }
 
 /* * * * * * * * * * * * * End - of - File * * * * * * * * * * * * * * */
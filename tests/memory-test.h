@@ -1,6 +1,7 @@
 #ifndef __MEMORY_TEST_H__
 #define __MEMORY_TEST_H__
 
+#include <atomic>
 #include <Memory/Auton.h>
 
 class I1
@@ -17,6 +18,16 @@ class I2
     virtual int n() = 0;
 };
 
+/// Interface for the multi-threaded test, its Implementation counts its instances
+class I3
+{
+ public:
+    virtual ~I3() {}
+    virtual int n() = 0;
+
+    static std::atomic<int> instances;
+};
+
 #endif /* __MEMORY_TEST_H__ */
 
 /* * * * * * * * * * * * * End - of - File * * * * * * * * * * * * * * */
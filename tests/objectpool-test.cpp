@@ -0,0 +1,104 @@
+#include <Memory/ObjectPool.h>
+#include <Threads/RingPipe.h>
+#include <iostream>
+#include <thread>
+#include <vector>
+#include "basic-tests.h"
+
+namespace
+{
+    std::atomic<int> messages(0);
+
+    struct Message
+    {
+        Message(int p_sender = 0, int p_index = 0):
+            sender(p_sender),
+            index(p_index),
+            check(p_sender * 1000003 + p_index)
+        {
+            ++messages;
+        }
+
+        ~Message()
+        {
+            --messages;
+        }
+
+        int sender;
+        int index;
+        int check;
+    };
+
+    typedef MEM::ObjectPool<Message> Pool;
+
+    /// Keeps an object until the exit of the thread
+    /*! It is created before the cache of the pool, so it is destroyed after that. */
+    struct Keeper
+    {
+        ~Keeper()
+        {
+            kept.reset();
+        }
+
+        MEM::pooled_ptr<Message> kept;
+    };
+
+    thread_local Keeper keeper;
+}
+
+/// The objects are allocated by some threads and released by another one
+/*! The elements move from the caches of the senders to the cache of the receiver, and back via the
+    global list. No object may be lost, and the memory must be reused. */
+static bool TestCrossThread(void)
+{
+ static const int senders = 3;
+ static const int count = 50000;
+ Threads::RingPipe<MEM::pooled_ptr<Message>, 64> pipe;
+ std::atomic<int> wrong(0);
+ std::thread receiver([&pipe, &wrong]() {
+    for (int i = 0; i < senders * count; ++i) {
+        MEM::pooled_ptr<Message> msg = pipe.pop();
+        if (!msg || msg->check != msg->sender * 1000003 + msg->index) {
+            ++wrong;
+        }
+    }
+ });
+ std::vector<std::thread> threads;
+ for (int i = 0; i < senders; ++i) {
+    threads.push_back(std::thread([&pipe, i]() {
+        for (int j = 0; j < count; ++j) {
+            pipe.push(MEM::make_pooled<Message>(i, j));
+        }
+    }));
+ }
+ for (std::thread & thread: threads) {
+    thread.join();
+ }
+ receiver.join();
+ Pool::Stats stats = Pool::Instance().GetStats();
+ std::cout << "* ObjectPool: capacity " << stats.capacity << ", in use " << stats.inUse << ", " << wrong << " error(s)" << std::endl;
+ return wrong == 0 && messages == 0 && stats.inUse == 0 && stats.capacity < (size_t)senders * count;
+}
+
+/// Releases an object after the cache of the thread has been destroyed
+static bool TestReleaseAtExit(void)
+{
+ std::thread worker([]() {
+    Keeper & k = keeper; // Constructs it before the cache
+    MEM::pooled_ptr<Message> temporary = MEM::make_pooled<Message>(-1, 1);
+    k.kept = MEM::make_pooled<Message>(-1, 2);
+ });
+ worker.join();
+ Pool::Stats stats = Pool::Instance().GetStats();
+ std::cout << "* ObjectPool at exit: in use " << stats.inUse << ", " << messages << " object(s) left" << std::endl;
+ return messages == 0 && stats.inUse == 0;
+}
+
+bool TestObjectPool(void)
+{
+ bool ok = TestCrossThread();
+ ok &= TestReleaseAtExit();
+ return ok;
+}
+
+/* * * * * * * * * * * * * End - of - File * * * * * * * * * * * * * * */
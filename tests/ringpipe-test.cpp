@@ -0,0 +1,87 @@
+#include <Threads/RingPipe.h>
+#include <iostream>
+#include <thread>
+#include <vector>
+#include "basic-tests.h"
+
+/// Passes numbers through a small pipe by several producers and consumers
+/*! The pipe is much smaller than the number of the elements, so both sides are blocked many
+    times. Each element must be received exactly once, so the sums must be equal. */
+static bool TestMpmc(void)
+{
+ static const int producers = 4;
+ static const int consumers = 4;
+ static const int64_t count = 100000;
+ Threads::RingPipe<int64_t, 16> pipe;
+ std::atomic<int64_t> sum(0);
+ std::atomic<int64_t> received(0);
+ std::vector<std::thread> threads;
+ for (int i = 0; i < producers; ++i) {
+    threads.push_back(std::thread([&pipe, i]() {
+        for (int64_t j = 1; j <= count; ++j) {
+            pipe.push(j * producers + i);
+        }
+    }));
+ }
+ for (int i = 0; i < consumers; ++i) {
+    threads.push_back(std::thread([&pipe, &sum, &received]() {
+        // The last 'consumers' elements are the terminators:
+        for (;;) {
+            int64_t value = pipe.pop();
+            if (value < 0) {
+                break;
+            }
+            sum += value;
+            ++received;
+        }
+    }));
+ }
+ for (int i = 0; i < producers; ++i) {
+    threads[i].join();
+ }
+ for (int i = 0; i < consumers; ++i) {
+    pipe.push(-1);
+ }
+ for (int i = producers; i < producers + consumers; ++i) {
+    threads[i].join();
+ }
+ int64_t expected = 0;
+ for (int i = 0; i < producers; ++i) {
+    for (int64_t j = 1; j <= count; ++j) {
+        expected += j * producers + i;
+    }
+ }
+ std::cout << "* RingPipe MPMC: received " << received << " of " << producers * count << ", sum "
+           << (sum == expected ? "ok" : "MISMATCH") << std::endl;
+ return received == producers * count && sum == expected && pipe.size() == 0;
+}
+
+/// A single producer and consumer must keep the order
+static bool TestSpscOrder(void)
+{
+ static const int count = 100000;
+ Threads::RingPipe<int, 8, Threads::Ring_SPSC> pipe;
+ bool ordered = true;
+ std::thread consumer([&pipe, &ordered]() {
+    for (int i = 0; i < count; ++i) {
+        if (pipe.pop() != i) {
+            ordered = false;
+        }
+    }
+ });
+ for (int i = 0; i < count; ++i) {
+    pipe.push(i);
+ }
+ consumer.join();
+ std::cout << "* RingPipe SPSC: " << (ordered ? "ordered" : "NOT ORDERED") << std::endl;
+ return ordered;
+}
+
+bool TestRingPipe(void)
+{
+ bool ok = TestMpmc();
+ ok &= TestSpscOrder();
+ return ok;
+}
+
+/* * * * * * * * * * * * * End - of - File * * * * * * * * * * * * * * */
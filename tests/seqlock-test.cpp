@@ -0,0 +1,70 @@
+#include <Threads/SeqLock.h>
+#include <iostream>
+#include <thread>
+#include <vector>
+#include "basic-tests.h"
+
+namespace
+{
+    /// It is larger than a word, so it cannot be copied atomically
+    struct Quad
+    {
+        int64_t a, b, c, d;
+    };
+}
+
+/// Readers must always see a consistent copy while the writers are modifying the value
+/*! The writers increment all the fields under \ref Threads::SeqWriteLock, so the fields of a
+    consistent copy are equal. At the end no increment may be lost. */
+bool TestSeqLock(void)
+{
+ static const int writers = 2;
+ static const int readers = 3;
+ static const int rounds = 100000;
+ Threads::SeqLock<Quad> lock(Quad { 0, 0, 0, 0 });
+ std::atomic<bool> done(false);
+ std::atomic<int> torn(0);
+ std::atomic<int64_t> reads(0);
+ std::vector<std::thread> threads;
+ for (int i = 0; i < readers; ++i) {
+    threads.push_back(std::thread([&]() {
+        int64_t last = 0;
+        while (!done.load()) {
+            Quad q = lock.Load();
+            if (q.a != q.b || q.a != q.c || q.a != q.d || q.a < last) {
+                ++torn;
+            }
+            last = q.a;
+            ++reads;
+        }
+    }));
+ }
+ std::vector<std::thread> writing;
+ for (int i = 0; i < writers; ++i) {
+    writing.push_back(std::thread([&lock]() {
+        for (int j = 0; j < rounds; ++j) {
+            Threads::SeqWriteLock<Quad> w(lock);
+            ++w->a;
+            ++w->b;
+            ++w->c;
+            ++w->d;
+        }
+    }));
+ }
+ for (std::thread & thread: writing) {
+    thread.join();
+ }
+ done = true;
+ for (std::thread & thread: threads) {
+    thread.join();
+ }
+ Quad result = lock.Load();
+ lock.Store(Quad { 1, 2, 3, 4 });
+ Quad stored = lock.Load();
+ bool ok = torn == 0 && result.a == (int64_t)writers * rounds && result.d == result.a;
+ ok &= stored.a == 1 && stored.b == 2 && stored.c == 3 && stored.d == 4;
+ std::cout << "* SeqLock: " << reads << " reads, " << torn << " inconsistent, final value " << result.a << std::endl;
+ return ok;
+}
+
+/* * * * * * * * * * * * * End - of - File * * * * * * * * * * * * * * */
@@ -0,0 +1,157 @@
+#include <Threads/ThreadArray.h>
+#include <iostream>
+#include <thread>
+#include <chrono>
+#include <vector>
+#include "basic-tests.h"
+
+namespace
+{
+    typedef std::chrono::steady_clock Clock;
+
+    struct Task
+    {
+        unsigned key;
+        int sequence;
+        int sleep_ms;
+    };
+
+    /// Records the tasks executed
+    class Array: public Threads::ThreadArray<unsigned, Task, 4>
+    {
+     public:
+        inline Array(uint32_t max_threads):
+            Threads::ThreadArray<unsigned, Task, 4>(max_threads, 64*1024),
+            executed(0),
+            wrong(0),
+            next(1000)
+        {
+        }
+
+        using Threads::ThreadArray<unsigned, Task, 4>::Size;
+
+        /// Waits until 'count' tasks have been executed
+        bool WaitExecuted(int count)
+        {
+            Clock::time_point until = Clock::now() + std::chrono::seconds(10);
+            while (executed < count) {
+                if (Clock::now() > until) {
+                    return false;
+                }
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+            return true;
+        }
+
+        class TestJob: public Job
+        {
+         public:
+            inline TestJob(Array & parent):
+                Job(parent, "test-job"),
+                myArray(parent)
+            {
+            }
+
+            virtual void Work(Task task) override
+            {
+                if (task.sleep_ms) {
+                    std::this_thread::sleep_for(std::chrono::milliseconds(task.sleep_ms));
+                }
+                // The job must not be re-used while it has a task, and the order must be kept:
+                if (GetIndex() != task.key || task.sequence != myArray.next[task.key % 1000]++) {
+                    ++myArray.wrong;
+                }
+                ++myArray.executed;
+            }
+
+         private:
+            Array & myArray;
+
+        }; // class TestJob
+
+        std::atomic<int> executed;
+
+        std::atomic<int> wrong;
+
+        /// The next expected sequence number for each key
+        std::vector<int> next;
+
+     private:
+        virtual JobPtr CreateJob(void) override
+        {
+            return JobPtr(new TestJob(*this));
+        }
+
+    }; // class Array
+}
+
+/// Two keys in the same shard get their own threads while the limit is not reached
+static bool TestCollision(void)
+{
+ Array array(16);
+ array.Post(0, Task { 0, 0, 300 });
+ Clock::time_point start = Clock::now();
+ array.Post(16, Task { 16, 0, 0 });
+ bool ok = array.WaitExecuted(1);
+ double elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+ ok &= elapsed < 0.2 && array[0] != array[16] && array.Size() == 2;
+ ok &= array.WaitExecuted(2) && array.wrong == 0;
+ std::cout << "* ThreadArray colliding keys: " << (ok ? "ok" : "WRONG") << ", " << elapsed << "s" << std::endl;
+ return ok;
+}
+
+/// When the limit is reached, an idle thread of another shard is stopped to make room
+static bool TestOtherShard(void)
+{
+ Array array(2);
+ array.Post(1, Task { 1, 0, 0 });
+ array.Post(2, Task { 2, 0, 0 });
+ bool ok = array.WaitExecuted(2);
+ array[1]->WaitIdle();
+ array[2]->WaitIdle();
+ // Key 3 has its own shard without any thread:
+ array.Post(3, Task { 3, 0, 0 });
+ ok &= array.WaitExecuted(3) && array.Size() == 2 && array.wrong == 0;
+ std::cout << "* ThreadArray other shard: " << (ok ? "ok" : "WRONG") << std::endl;
+ return ok;
+}
+
+/// Several threads post to more keys than threads
+/*! The busy jobs must not be re-used for other keys, and the tasks of each key must be executed in
+    the order of posting. The mailboxes are small, so the posters are blocked often. */
+static bool TestMailbox(void)
+{
+ static const int posters = 4;
+ static const int keys_per_poster = 8;
+ static const int rounds = 500;
+ Array array(6);
+ std::vector<std::thread> threads;
+ for (int p = 0; p < posters; ++p) {
+    threads.push_back(std::thread([&array, p]() {
+        for (int r = 0; r < rounds; ++r) {
+            for (int k = 0; k < keys_per_poster; ++k) {
+                // Each key is posted by one thread only, so its order is defined:
+                unsigned key = p * keys_per_poster + k;
+                array.Post(key, Task { key, r, (r % 100 == 0) ? 1 : 0 });
+            }
+        }
+    }));
+ }
+ for (std::thread & thread: threads) {
+    thread.join();
+ }
+ bool ok = array.WaitExecuted(posters * keys_per_poster * rounds);
+ ok &= array.wrong == 0 && array.Size() <= 6;
+ std::cout << "* ThreadArray mailbox: " << array.executed << " task(s), " << array.wrong << " error(s)" << std::endl;
+ return ok;
+}
+
+bool TestThreadArray(void)
+{
+ bool ok = TestCollision();
+ ok &= TestOtherShard();
+ ok &= TestMailbox();
+ return ok;
+}
+
+/* * * * * * * * * * * * * End - of - File * * * * * * * * * * * * * * */
@@ -0,0 +1,127 @@
+#include <Threads/Semaphore.h>
+#include <Threads/Condition.h>
+#include <Threads/DataPipe.h>
+#include <Threads/RingPipe.h>
+#include <iostream>
+#include <thread>
+#include "basic-tests.h"
+
+namespace
+{
+    const std::chrono::milliseconds TIMEOUT(100);
+
+    /// Checks a wait that must time out: it must return false after about \ref TIMEOUT
+    class Expiry
+    {
+     public:
+        inline Expiry(void):
+            myStart(Threads::Clock::now())
+        {
+        }
+
+        bool Check(const char * name, bool result) const
+        {
+            double elapsed = std::chrono::duration<double>(Threads::Clock::now() - myStart).count();
+            // The lower limit has a small tolerance for the clock resolution:
+            bool ok = !result && elapsed >= 0.095 && elapsed < 1.0;
+            if (!ok) {
+                std::cout << "* Timed wait " << name << ": " << (result ? "succeeded" : "failed") << " after " << elapsed << "s" << std::endl;
+            }
+            return ok;
+        }
+
+     private:
+        Threads::Clock::time_point myStart;
+    };
+
+    /// Calls finish() after a short time, the waiters must return at once
+    template <class PIPE>
+    bool FinishWakes(const char * name, PIPE & pipe, bool pop)
+    {
+        Threads::Clock::time_point start = Threads::Clock::now();
+        std::thread finisher([&pipe]() {
+            std::this_thread::sleep_for(std::chrono::milliseconds(50));
+            pipe.finish();
+        });
+        int value = 0;
+        bool result = pop ? pipe.pop_for(value, std::chrono::seconds(10)) : pipe.push_for(value, std::chrono::seconds(10));
+        finisher.join();
+        double elapsed = std::chrono::duration<double>(Threads::Clock::now() - start).count();
+        bool ok = !result && elapsed < 1.0;
+        if (!ok) {
+            std::cout << "* Timed wait " << name << " after finish(): " << (result ? "succeeded" : "failed") << " after " << elapsed << "s" << std::endl;
+        }
+        return ok;
+    }
+}
+
+/// The timed waits must expire after the timeout, neither at once nor never
+/*! Also checks that they succeed if they are not blocked, and \ref Threads::DataPipe::finish()
+    wakes up the timed waiters. */
+bool TestTimedWait(void)
+{
+ bool ok = true;
+
+ {
+    Threads::Semaphore semaphore;
+    Expiry e1;
+    ok &= e1.Check("Semaphore::WaitFor()", semaphore.WaitFor(TIMEOUT));
+    Expiry e2;
+    ok &= e2.Check("Semaphore::Wait(ms)", semaphore.Wait((uint32_t)TIMEOUT.count()));
+    semaphore.Post();
+    ok &= semaphore.WaitFor(TIMEOUT);
+ }
+
+ {
+    Threads::Mutex mutex("TimedWait");
+    Threads::Condition condition;
+    Threads::Lock _l(mutex);
+    Expiry e1;
+    ok &= e1.Check("Condition::WaitFor()", condition.WaitFor(mutex, TIMEOUT));
+    Expiry e2;
+    ok &= e2.Check("Condition::WaitUntil()", condition.WaitUntil(mutex, Threads::DeadlineAfter(TIMEOUT)));
+ }
+
+ {
+    Threads::DataPipe<int, 1> pipe;
+    int value = 0;
+    Expiry e1;
+    ok &= e1.Check("DataPipe::pop_for()", pipe.pop_for(value, TIMEOUT));
+    Expiry e2;
+    ok &= e2.Check("DataPipe::pop_until()", pipe.pop_until(value, Threads::DeadlineAfter(TIMEOUT)));
+    ok &= pipe.push_for(1, TIMEOUT);
+    Expiry e3;
+    ok &= e3.Check("DataPipe::push_for()", pipe.push_for(2, TIMEOUT));
+    ok &= pipe.pop_for(value, TIMEOUT) && value == 1;
+ }
+
+ {
+    Threads::RingPipe<int, 2> pipe;
+    int value = 0;
+    Expiry e1;
+    ok &= e1.Check("RingPipe::pop_for()", pipe.pop_for(value, TIMEOUT));
+    ok &= pipe.push_for(1, TIMEOUT) && pipe.push_for(3, TIMEOUT);
+    Expiry e2;
+    ok &= e2.Check("RingPipe::push_for()", pipe.push_for(2, TIMEOUT));
+    ok &= pipe.pop_for(value, TIMEOUT) && value == 1;
+ }
+
+ {
+    Threads::DataPipe<int, 1> empty;
+    ok &= FinishWakes("DataPipe::pop_for()", empty, true);
+    Threads::DataPipe<int, 1> full;
+    full.push(0);
+    ok &= FinishWakes("DataPipe::push_for()", full, false);
+    Threads::RingPipe<int, 2> ring_empty;
+    ok &= FinishWakes("RingPipe::pop_for()", ring_empty, true);
+    Threads::RingPipe<int, 2> ring_full;
+    ring_full.push(0);
+    ring_full.push(0);
+    ok &= FinishWakes("RingPipe::push_for()", ring_full, false);
+ }
+
+ std::cout << "* Timed waits: " << (ok ? "ok" : "WRONG") << std::endl;
+ return ok;
+}
+
+/* * * * * * * * * * * * * End - of - File * * * * * * * * * * * * * * */
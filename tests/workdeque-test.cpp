@@ -0,0 +1,86 @@
+#include <Threads/WorkDeque.h>
+#include <iostream>
+#include <thread>
+#include <vector>
+#include "basic-tests.h"
+
+/// The owner pops in LIFO order, while the thieves steal in FIFO order
+static bool TestOrder(void)
+{
+ Threads::WorkDeque<int> deque(4);
+ for (int i = 0; i < 10; ++i) {
+    deque.Push(i);
+ }
+ int value = -1;
+ bool ok = deque.Steal(value) && value == 0;
+ ok &= deque.Pop(value) && value == 9;
+ ok &= deque.Steal(value) && value == 1;
+ ok &= deque.Pop(value) && value == 8;
+ for (int i = 7; i >= 2; --i) {
+    ok &= deque.Pop(value) && value == i;
+ }
+ ok &= !deque.Pop(value) && !deque.Steal(value) && deque.Empty();
+ std::cout << "* WorkDeque order: " << (ok ? "ok" : "WRONG") << std::endl;
+ return ok;
+}
+
+/// The owner pushes and pops while the thieves steal
+/*! The deque starts small, so it grows meanwhile. Each element must be taken exactly once: either
+    by the owner or by a thief. */
+static bool TestSteal(void)
+{
+ static const int thieves = 3;
+ static const int count = 200000;
+ Threads::WorkDeque<int> deque(2);
+ std::vector<std::atomic<int>> taken(count);
+ for (std::atomic<int> & t: taken) {
+    t.store(0);
+ }
+ std::atomic<bool> done(false);
+ std::atomic<int> stolen(0);
+ std::vector<std::thread> threads;
+ for (int i = 0; i < thieves; ++i) {
+    threads.push_back(std::thread([&]() {
+        int value;
+        while (!done.load() || !deque.Empty()) {
+            if (deque.Steal(value)) {
+                ++taken[value];
+                ++stolen;
+            }
+        }
+    }));
+ }
+ int popped = 0;
+ int value;
+ for (int i = 0; i < count; ++i) {
+    deque.Push(i);
+    // Pops every third element, so the deque is growing and shrinking:
+    if (i % 3 == 2 && deque.Pop(value)) {
+        ++taken[value];
+        ++popped;
+    }
+ }
+ while (deque.Pop(value)) {
+    ++taken[value];
+    ++popped;
+ }
+ done = true;
+ for (std::thread & thread: threads) {
+    thread.join();
+ }
+ int wrong = 0;
+ for (std::atomic<int> & t: taken) {
+    wrong += t != 1;
+ }
+ std::cout << "* WorkDeque steal: popped " << popped << ", stolen " << stolen << ", " << wrong << " error(s)" << std::endl;
+ return wrong == 0 && popped + stolen == count;
+}
+
+bool TestWorkDeque(void)
+{
+ bool ok = TestOrder();
+ ok &= TestSteal();
+ return ok;
+}
+
+/* * * * * * * * * * * * * End - of - File * * * * * * * * * * * * * * */